@@ -5,7 +5,9 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
 
 #include <grlib/adj_list.hpp>
 #include <grlib/bfs.hpp>
@@ -18,9 +20,17 @@
 namespace Option {
         std::string dpi = "100";
         std::string layout = "neato";
+        std::string layout_cache = "";
         std::string input_file = "";
         std::string log_file = "";
         std::string extension = "png";
+        std::string gif_file = "";
+        std::string delay = "50";
+        std::string every = "1";
+        std::string max_frames = "0";
+        size_t sample_every = 1;
+        size_t frames_limit = 0;
+        std::string jobs = std::to_string(std::max(1u, std::thread::hardware_concurrency()));
         bool should_output = false;
         std::ofstream log_stream;
 
@@ -28,10 +38,16 @@ namespace Option {
 R"(Generate breadth-first search visualization of provided graph.
 Usage: bfs_vizu [OPTION]... [FILE]
 Program options:
+--delay=<val>:               time each frame of gif is shown, in hundredths of a second (50 default)
 --dpi=<val>:                 dpi of generated files
+--every=<val>:               render every n-th step only, changes of skipped steps show in the next frame
 [--extension -e]=<val>:      extension of generated files, png is default
+--gif=<file>:                write all frames to one animated gif instead of separate files
 --help -h:                   show help
+--jobs=<val>:                number of processes rendering frames, number of cores is default
 --layout=<val>:              graph layout (neato default, see GraphViz documentation for possible layouts)
+--layout-cache=<dir>:        directory keeping computed layouts, a graph is laid out once
+--max-frames=<val>:          render at most that many frames evenly spread over the steps
 --log=<file>:                print program informations to the provided file.
 --verbose -v:                print program informations to the standard input
 [FILE]:                      file containing description of the graph, formats .txt and .dot are possible
@@ -39,6 +55,8 @@ Program options:
 Examples:
         $> bfs_vizu --log=out.log --layout=neato --dpi=300 graph.dot
         $> bfs_vizu -v --extension=jpg --layout=neato --dpi=300 graph.dot
+        $> bfs_vizu --gif=bfs_vizu.gif --delay=100 graph.dot
+        $> bfs_vizu --gif=bfs_vizu.gif --max-frames=300 --layout=sfdp graph.dot
 )";
 }
 
@@ -57,11 +75,17 @@ void process_args(int argc, char** argv)
         const char* const short_opts = "o:e:hv";
 
         const option long_opts[] = {
+                {"delay", required_argument, nullptr, 't'},
                 {"dpi", required_argument, nullptr, 'd'},
+                {"every", required_argument, nullptr, 'n'},
                 {"extension", required_argument, nullptr, 'e'},
+                {"gif", required_argument, nullptr, 'a'},
                 {"layout", required_argument, nullptr, 'l'},
+                {"layout-cache", required_argument, nullptr, 'k'},
                 {"log", required_argument, nullptr, 'g'},
+                {"max-frames", required_argument, nullptr, 'm'},
                 {"help", no_argument, nullptr, 'h'},
+                {"jobs", required_argument, nullptr, 'j'},
                 {"verbose", no_argument, nullptr, 'v'},
                 {nullptr, no_argument, nullptr, 0}
         };
@@ -79,9 +103,27 @@ void process_args(int argc, char** argv)
                 case 'e':
                         Option::extension = optarg;
                 break;
+                case 'a':
+                        Option::gif_file = optarg;
+                break;
+                case 't':
+                        Option::delay = optarg;
+                break;
+                case 'j':
+                        Option::jobs = optarg;
+                break;
+                case 'n':
+                        Option::every = optarg;
+                break;
+                case 'm':
+                        Option::max_frames = optarg;
+                break;
                 case 'l':
                         Option::layout = optarg;
                 break;
+                case 'k':
+                        Option::layout_cache = optarg;
+                break;
                 case 'v':
                         Option::should_output = true;
                 break;
@@ -119,6 +161,36 @@ void process_args(int argc, char** argv)
                         exit(0);
                 }
 
+        // check if delay is a number
+        if (Option::delay == "" or !std::all_of(Option::delay.begin(), Option::delay.end(),
+                        [] (char ch) { return std::isdigit(ch); })) {
+                std::cerr << "delay is not numeric value: " << Option::delay << "\n";
+                exit(0);
+        }
+
+        // check if number of jobs is a positive number
+        if (Option::jobs == "" or Option::jobs.size() > 9
+                        or !std::all_of(Option::jobs.begin(), Option::jobs.end(),
+                                [] (char ch) { return std::isdigit(ch); })
+                        or std::stoul(Option::jobs) == 0) {
+                std::cerr << "jobs is not positive numeric value: " << Option::jobs << "\n";
+                exit(0);
+        }
+
+        // check if sampling values are numbers, parse them once
+        auto parse_sampling = [] (const std::string& value) -> size_t {
+                if (value == "" or value.size() > 9 or !std::all_of(value.begin(), value.end(),
+                                [] (char ch) { return std::isdigit(ch); })) {
+                        std::cerr << "sampling value is not numeric value: " << value << "\n";
+                        exit(0);
+                }
+
+                return std::stoul(value);
+        };
+
+        Option::sample_every = parse_sampling(Option::every);
+        Option::frames_limit = parse_sampling(Option::max_frames);
+
         std::vector<std::string> layouts = {"dot", "neato",
                 "fdp", "sfdp", "twopi", "circo"};
 
@@ -146,17 +218,43 @@ int main(int argc, char** argv)
                 return 0;
         }
 
-        gviz::graphviz_context context(cgraph, Option::layout);
+        gviz::graphviz_context context;
+
+        if (Option::layout_cache != "") {
+                try {
+                        if (gviz::set_cached_layout(context, cgraph, Option::layout, Option::layout_cache)
+                                        and Option::should_output)
+                                out() << "Layout loaded from: " << Option::layout_cache << "\n";
+                } catch (std::exception& e) {
+                        out() << e.what() << "\n";
+                        return 0;
+                }
+        } else {
+                context.set_layout(cgraph, Option::layout);
+        }
 
         grlib::adj_list<grlib::Basic_edge> alist(cgraph);
 
-        try {
-                gviz::render(context, cgraph, "0", Option::extension);
-        } catch (std::exception& e) {
-                out() << e.what() << "\n";
+        std::unique_ptr<gviz::gif_animation> animation;
+
+        if (Option::gif_file != "") {
+                try {
+                        animation = std::make_unique<gviz::gif_animation>(Option::gif_file,
+                                        std::stoul(Option::delay));
+                } catch (std::exception& e) {
+                        out() << e.what() << "\n";
+                        return 0;
+                }
         }
 
-        int frame_number = 1;
+        // callbacks record changes of attributes, frames are rendered in parallel at the end
+        gviz::frame_recorder recorder;
+
+        // attributes are looked up once, vertices map to their nodes directly
+        gviz::Attribute fillcolor(cgraph, AGNODE, "fillcolor", "blue");
+        gviz::Attribute color(cgraph, AGEDGE, "color");
+
+        recorder.frame();
 
         using bfs_context = grlib::bfs_context<grlib::Basic_edge>;
 
@@ -166,19 +264,15 @@ int main(int argc, char** argv)
                                 << alist.vmap.names[v] << "\"\n";
                 }
 
-                gviz::Node node(cgraph.find_node(alist.vmap.names[v]));
+                gviz::Node node(alist.vmap.node(v));
 
-                if (!node.set_attr("fillcolor", "#ff4000")) {
-                        grlib_log("failed in set_attr_safe(%s, %s) on frame %d\n",
-                                "fillcolor", "#D2691E", frame_number);
+                if (!recorder.set_attr(node, fillcolor, "#ff4000")) {
+                        grlib_log("failed in set_attr_safe(%s, %s) on frame %zu\n",
+                                "fillcolor", "#D2691E", recorder.frames_number());
                         return;
                 }
 
-                try {
-                        gviz::render(context, cgraph, std::to_string(frame_number++), Option::extension);
-                } catch (std::exception& e) {
-                        out() << e.what() << "\n";
-                }
+                recorder.frame();
         };
 
         auto process_edge = [&] ([[maybe_unused]]int x, int y, [[maybe_unused]]bfs_context& bfs) {
@@ -187,30 +281,26 @@ int main(int argc, char** argv)
                                 << alist.vmap.names[y] << "\"\n";
                 }
 
-                gviz::Node node1 = cgraph.find_node(alist.vmap.names[x]);
-                gviz::Node node2 = cgraph.find_node(alist.vmap.names[y]);
+                gviz::Node node1(alist.vmap.node(x));
+                gviz::Node node2(alist.vmap.node(y));
 
                 gviz::Edge edge = cgraph.find_edge(node1, node2);
 
-                if (!edge.set_attr("color", "red")) {
+                if (!recorder.set_attr(edge, color, "red")) {
                         out() << "edge: failed in set_attr_safe(color, red) on frame "
-                                << frame_number << "\n";
+                                << recorder.frames_number() << "\n";
 
                         return;
                 }
 
-                if (!node2.set_attr_safe("fillcolor", "#0080ff", "blue")) {
+                if (!recorder.set_attr(node2, fillcolor, "#0080ff")) {
                         out() << "failed in set_attr_safe(fillcolor, #D2691E) on frame "
-                                                << frame_number << "\n";
+                                                << recorder.frames_number() << "\n";
 
                         return;
                 }
 
-                try {
-                        gviz::render(context, cgraph, std::to_string(frame_number++), Option::extension);
-                } catch (std::exception& e) {
-                        out() << e.what() << "\n";
-                }
+                recorder.frame();
         };
 
         auto process_vertex_late = [&] (int v, bfs_context& bfs) {
@@ -224,6 +314,36 @@ int main(int argc, char** argv)
 
         grlib::bfs(bfs_cxt);
 
+        // steps which did not change anything are skipped already, long animations are sampled
+        recorder.sample(Option::sample_every);
+
+        if (Option::frames_limit > 0)
+                recorder.limit(Option::frames_limit);
+
+        if (Option::should_output)
+                out() << "Rendering " << recorder.frames_number() << " frames\n";
+
+        try {
+                std::vector<size_t> failed = animation
+                        ? gviz::render_frames(context, cgraph, recorder, *animation,
+                                        std::stoul(Option::jobs))
+                        : gviz::render_frames(context, cgraph, recorder, Option::extension,
+                                        std::stoul(Option::jobs));
+
+                for (size_t frame : failed)
+                        out() << "Rendering frame " << frame << " failed\n";
+        } catch (std::exception& e) {
+                out() << e.what() << "\n";
+        }
+
+        // frames rendered before an error still make a valid animation
+        try {
+                if (animation)
+                        animation->close();
+        } catch (std::exception& e) {
+                out() << e.what() << "\n";
+        }
+
         return 0;
 }
 
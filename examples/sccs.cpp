@@ -5,11 +5,15 @@
 #include <getopt.h>
 #include <iostream>
 #include <map>
+#include <queue>
+#include <sstream>
 #include <string>
 
 #include <iostream>
 
 #include "grlib/adj_list.hpp"
+#include "grlib/communities.hpp"
+#include "grlib/csr.hpp"
 #include "grlib/sccs.hpp"
 #include "grlib/utility.hpp"
 #include <grlib/grlib.hpp>
@@ -18,7 +22,8 @@
 
 namespace Option {
         std::string dpi = "100";
-        std::string layout = "neato";
+        std::string layout = "";
+        std::string layout_cache = "";
         std::string input_file = "";
         std::string output_file = "";
         std::string extension = "";
@@ -26,6 +31,10 @@ namespace Option {
         bool should_output = false;
         std::ofstream log_stream;
         bool randomize = false;
+        bool communities = false;
+        bool overview = false;
+        std::string max_nodes = "1000";
+        std::string details = "";
 
         std::string help =
 R"(Tarjan's strongly connected components algorithm visualization of provided graph.
@@ -33,16 +42,22 @@ Usage: sccs [OPTION]... [FILE]
 Program options:
 --dpi=<val>:                 dpi of generated files
 --help -h:                   show help
---layout=<val>:              graph layout (neato default, see GraphViz documentation for possible layouts)
+--layout=<val>:              graph layout (neato default, sfdp with --overview, see GraphViz documentation for possible layouts)
+--layout-cache=<dir>:        directory keeping computed layouts, a graph is laid out once
 --log=<file>:                print program informations to the provided file.
 --verbose -v:                print program informations to the standard input
 --output -o:                 output file
 --randomize -r:              randomize color of components
+--communities -c:            color communities found by label propagation instead of components
+--overview -w:               render components as single nodes, for graphs too large to show every node
+--max-nodes=<val>:           upper limit of nodes of the overview and of each detail, 1000 default
+--detail=<list>:             comma separated components rendered in detail next to the overview
 [FILE]:                      file containing description of the graph, formats .txt and .dot are possible
 
 Examples:
         $> sccs --log=out.log --layout=neato --dpi=300 -o out.png graph.dot
         $> sccs -v  --layout=neato --dpi=300 -o out.jpg graph.dot
+        $> sccs --overview --max-nodes=500 --detail=1,4 -o out.png graph.dot
 )";
 }
 
@@ -58,16 +73,21 @@ void process_args(int argc, char** argv)
                 exit(0);
         }
 
-        const char* const short_opts = "o:hvr";
+        const char* const short_opts = "o:hvrcw";
 
         const option long_opts[] = {
                 {"dpi", required_argument, nullptr, 'd'},
                 {"output", required_argument, nullptr, 'o'},
                 {"layout", required_argument, nullptr, 'l'},
+                {"layout-cache", required_argument, nullptr, 'k'},
                 {"log", required_argument, nullptr, 'g'},
                 {"help", no_argument, nullptr, 'h'},
                 {"verbose", no_argument, nullptr, 'v'},
                 {"randomize", no_argument, nullptr, 'r'},
+                {"communities", no_argument, nullptr, 'c'},
+                {"overview", no_argument, nullptr, 'w'},
+                {"max-nodes", required_argument, nullptr, 'x'},
+                {"detail", required_argument, nullptr, 'i'},
                 {nullptr, no_argument, nullptr, 0}
         };
 
@@ -87,6 +107,9 @@ void process_args(int argc, char** argv)
                 case 'l':
                         Option::layout = optarg;
                 break;
+                case 'k':
+                        Option::layout_cache = optarg;
+                break;
                 case 'v':
                         Option::should_output = true;
                 break;
@@ -97,6 +120,18 @@ void process_args(int argc, char** argv)
                 case 'r':
                         Option::randomize = true;
                 break;
+                case 'c':
+                        Option::communities = true;
+                break;
+                case 'w':
+                        Option::overview = true;
+                break;
+                case 'x':
+                        Option::max_nodes = optarg;
+                break;
+                case 'i':
+                        Option::details = optarg;
+                break;
                 case 'h':
                 case '?':
                 default:
@@ -127,6 +162,25 @@ void process_args(int argc, char** argv)
                         exit(0);
                 }
 
+        // check if max-nodes is a positive number
+        if (Option::max_nodes.empty() or Option::max_nodes.size() > 9
+                        or !std::all_of(Option::max_nodes.begin(), Option::max_nodes.end(),
+                                [] (char ch) { return std::isdigit(ch); })
+                        or std::stoul(Option::max_nodes) == 0) {
+                std::cerr << "max-nodes is not positive numeric value: " << Option::max_nodes << "\n";
+                exit(0);
+        }
+
+        // check if details are numbers separated by commas
+        for (char ch : Option::details)
+                if (!std::isdigit(ch) and ch != ',') {
+                        std::cerr << "detail is not a list of components: " << Option::details << "\n";
+                        exit(0);
+                }
+
+        if (Option::layout == "")
+                Option::layout = Option::overview ? "sfdp" : "neato";
+
         std::vector<std::string> layouts = {"dot", "neato",
                 "fdp", "sfdp", "twopi", "circo"};
 
@@ -147,6 +201,164 @@ void process_args(int argc, char** argv)
         Option::output_file = Option::output_file.substr(0, dot_index);
 }
 
+/**
+ * Lay out the graph with the layout from options, see --layout-cache
+ * @return bool indicating whether the graph is laid out
+ */
+bool lay_out(gviz::graphviz_context& context, gviz::cgraph& graph)
+{
+        if (Option::layout_cache == "") {
+                context.set_layout(graph, Option::layout);
+                return true;
+        }
+
+        try {
+                if (gviz::set_cached_layout(context, graph, Option::layout, Option::layout_cache)
+                                and Option::should_output)
+                        out() << "Layout loaded from: " << Option::layout_cache << "\n";
+        } catch (std::exception& e) {
+                out() << e.what() << "\n";
+                return false;
+        }
+
+        return true;
+}
+
+/**
+ * Nodes shown in detail of the component: all of them or, when there are more than
+ * max_nodes, those reached first by bfs from its vertices of the highest degree
+ */
+std::vector<Agnode_t*> detail_nodes(grlib::adj_list<grlib::Basic_edge>& alist,
+                const std::vector<int>& labels, int label, size_t max_nodes)
+{
+        std::vector<grlib::vertex_id> members;
+
+        for (size_t v = 0; v < alist.vmap.max_index; v++)
+                if (labels[v] == label)
+                        members.push_back(v);
+
+        std::stable_sort(members.begin(), members.end(), [&] (int a, int b) {
+                return alist.edges[a].size() > alist.edges[b].size();
+        });
+
+        std::vector<bool> visited(alist.vertices_capacity(), false);
+        std::vector<Agnode_t*> nodes;
+
+        for (grlib::vertex_id seed : members) {
+                if (visited[seed])
+                        continue;
+
+                std::queue<grlib::vertex_id> queue;
+                queue.push(seed);
+                visited[seed] = true;
+
+                while (!queue.empty() and nodes.size() < max_nodes) {
+                        grlib::vertex_id v = queue.front();
+                        queue.pop();
+                        nodes.push_back(alist.vmap.node(v));
+
+                        for (const auto& edge : alist.edges[v])
+                                if (!visited[edge.y] and labels[edge.y] == label) {
+                                        visited[edge.y] = true;
+                                        queue.push(edge.y);
+                                }
+                }
+
+                if (nodes.size() >= max_nodes)
+                        break;
+        }
+
+        return nodes;
+}
+
+/**
+ * Render the graph of components, laid out and drawn in time depending on max-nodes
+ * instead of the graph size, then details of components chosen with --detail
+ */
+void render_overview(gviz::graphviz_context& context, gviz::cgraph& cgraph,
+                grlib::adj_list<grlib::Basic_edge>& alist, const std::vector<int>& labels)
+{
+        size_t max_nodes = std::stoul(Option::max_nodes);
+        gviz::cgraph overview = gviz::quotient_graph(cgraph, alist.vmap.nodes, labels, max_nodes);
+
+        if (!overview.def_graph_attr("dpi", Option::dpi) or !gviz::set_large_graph_attrs(overview)) {
+                out() << "Setting attributes of overview failed!\n";
+                return;
+        }
+
+        // components merged into "other" share its color in details
+        Color_pool color_pool(overview.nodes_number());
+        std::map<std::string, std::string> colors;
+        gviz::Attribute fillcolor(overview, AGNODE, "fillcolor", "white");
+
+        for (gviz::Node node : overview) {
+                std::string color = node.name() == "other" ? "#D3D3D3"
+                        : Option::randomize ? color_pool.random_unique_color() : color_pool.next_color();
+
+                colors[node.name()] = color;
+                fillcolor.set(node, color);
+        }
+
+        if (Option::should_output)
+                out() << "overview nodes: " << overview.nodes_number() << "\n";
+
+        if (!lay_out(context, overview))
+                return;
+
+        try {
+                gviz::render(context, overview, Option::output_file, Option::extension);
+        } catch (std::exception& e) {
+                out() << e.what() << "\n";
+        }
+
+        std::stringstream details(Option::details);
+        std::string component;
+
+        while (std::getline(details, component, ',')) {
+                if (component.empty())
+                        continue;
+
+                // components are numbered from 1, too long numbers do not name any
+                int number = component.size() > 9 ? 0 : std::stoi(component);
+                std::string label = std::to_string(number);
+                std::vector<Agnode_t*> nodes = detail_nodes(alist, labels, number, max_nodes);
+
+                if (nodes.empty()) {
+                        out() << "No component: " << component << "\n";
+                        continue;
+                }
+
+                gviz::cgraph detail = gviz::induced_graph(cgraph, nodes, "component_" + label);
+
+                if (!detail.def_graph_attr("dpi", Option::dpi) or !gviz::set_large_graph_attrs(detail)) {
+                        out() << "Setting attributes of component " << label << " failed!\n";
+                        continue;
+                }
+
+                std::string color = colors.count(label) ? colors[label] : colors["other"];
+                gviz::Attribute detail_fillcolor(detail, AGNODE, "fillcolor", "white");
+                gviz::Attribute style(detail, AGNODE, "style", "filled");
+
+                for (gviz::Node node : detail) {
+                        detail_fillcolor.set(node, color);
+                        style.set(node, "filled");
+                }
+
+                if (!lay_out(context, detail))
+                        continue;
+
+                try {
+                        gviz::render(context, detail, Option::output_file + "_" + label, Option::extension);
+                } catch (std::exception& e) {
+                        out() << e.what() << "\n";
+                }
+
+                context.free_layout(detail);
+        }
+
+        context.free_layout(overview);
+}
+
 int main(int argc, char** argv)
 {
         process_args(argc, argv);
@@ -163,22 +375,45 @@ int main(int argc, char** argv)
                 return 0;
         }
 
-        gviz::graphviz_context context(cgraph, Option::layout);
+        gviz::graphviz_context context;
+
+        // the overview lays out its own, small graph only
+        if (!Option::overview and !lay_out(context, cgraph))
+                return 0;
 
         grlib::adj_list<grlib::Basic_edge> alist(cgraph);
 
-        grlib::sccs_context<grlib::Basic_edge> sccs_cxt(alist);
+        // label of each vertex numbered from 1, -1 when vertex is not labeled
+        std::vector<int> labels;
+        int labels_number;
+
+        if (Option::communities) {
+                grlib::communities_context communities_cxt(grlib::make_csr(alist));
+                grlib::label_propagation(communities_cxt);
 
-        grlib::sccs(sccs_cxt);
+                labels = std::move(communities_cxt.community);
+                labels_number = communities_cxt.communities_number;
+        } else {
+                grlib::sccs_context<grlib::Basic_edge> sccs_cxt(alist);
+                grlib::sccs(sccs_cxt);
+
+                labels = std::move(sccs_cxt.scc);
+                labels_number = sccs_cxt.components_number;
+        }
 
         if (Option::should_output) {
-                out() << "number of components: " << sccs_cxt.components_number << std::endl;
-                for (size_t i = 0; i < alist.edges.size(); i++)
-                        out() << "\"" << alist.vmap.names[i] << "\": " << sccs_cxt.scc[i] << "\n";
+                out() << "number of components: " << labels_number << std::endl;
+                for (size_t i = 0; i < alist.vmap.max_index; i++)
+                        out() << "\"" << alist.vmap.names[i] << "\": " << labels[i] << "\n";
         }
 
-        Color_pool color_pool;
-        std::vector<std::string> colors(sccs_cxt.components_number);
+        if (Option::overview) {
+                render_overview(context, cgraph, alist, labels);
+                return 0;
+        }
+
+        Color_pool color_pool(labels_number);
+        std::vector<std::string> colors(labels_number);
 
         for (size_t i = 0; i < colors.size(); i++) {
                 try {
@@ -189,11 +424,17 @@ int main(int argc, char** argv)
                 }
         }
 
-        for (gviz::Node node : cgraph) {
-                int node_index = alist.vmap.indexes[node.name()];
-                int color_index = sccs_cxt.scc[node_index] - 1;
+        gviz::Attribute fillcolor(cgraph, AGNODE, "fillcolor", "white");
+
+        for (size_t v = 0; v < alist.vmap.max_index; v++) {
+                gviz::Node node(alist.vmap.node(v));
+                int color_index = labels[v] - 1;
+
+                // isolated vertices are not assigned to any component
+                if (color_index < 0)
+                        continue;
 
-                if (!node.set_attr_safe("fillcolor", colors[color_index], "white")) {
+                if (!fillcolor.set(node, colors[color_index])) {
                         out() << "set_attr_safe(fillcolor, " << colors[color_index] << ", white) failed\n";
                 }
         }
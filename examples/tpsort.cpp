@@ -5,7 +5,9 @@
 #include <getopt.h>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
 
 #include <grlib/adj_list.hpp>
 #include <grlib/tpsort.hpp>
@@ -17,9 +19,17 @@
 namespace Option {
         std::string dpi = "100";
         std::string layout = "neato";
+        std::string layout_cache = "";
         std::string input_file = "";
         std::string log_file = "";
         std::string extension = "png";
+        std::string gif_file = "";
+        std::string delay = "50";
+        std::string every = "1";
+        std::string max_frames = "0";
+        size_t sample_every = 1;
+        size_t frames_limit = 0;
+        std::string jobs = std::to_string(std::max(1u, std::thread::hardware_concurrency()));
         bool should_output = false;
         std::ofstream log_stream;
 
@@ -27,10 +37,16 @@ namespace Option {
 R"(Topological sorting algorithm visualization of provided graph.
 Usage: tpsort [OPTION]... [FILE]
 Program options:
+--delay=<val>:               time each frame of gif is shown, in hundredths of a second (50 default)
 --dpi=<val>:                 dpi of generated files
+--every=<val>:               render every n-th step only, changes of skipped steps show in the next frame
 [--extension -e]=<val>:      extension of generated files, png is default
+--gif=<file>:                write all frames to one animated gif instead of separate files
 --help -h:                   show help
+--jobs=<val>:                number of processes rendering frames, number of cores is default
 --layout=<val>:              graph layout (neato default, see GraphViz documentation for possible layouts)
+--layout-cache=<dir>:        directory keeping computed layouts, a graph is laid out once
+--max-frames=<val>:          render at most that many frames evenly spread over the steps
 --log=<file>:                print program informations to the provided file.
 --verbose -v:                print program informations to the standard input
 [FILE]:                      file containing description of the graph, formats .txt and .dot are possible
@@ -38,6 +54,8 @@ Program options:
 Examples:
         $> tpsort --log=out.log --layout=neato --dpi=300 graph.dot
         $> tpsort -v --extension=jpg --layout=neato --dpi=300 graph.dot
+        $> tpsort --gif=tpsort.gif --delay=100 graph.dot
+        $> tpsort --gif=tpsort.gif --max-frames=300 --layout=sfdp graph.dot
 )";
 }
 
@@ -50,11 +68,17 @@ void process_args(int argc, char** argv)
         const char* const short_opts = "o:e:hv";
 
         const option long_opts[] = {
+                {"delay", required_argument, nullptr, 't'},
                 {"dpi", required_argument, nullptr, 'd'},
+                {"every", required_argument, nullptr, 'n'},
                 {"extension", required_argument, nullptr, 'e'},
+                {"gif", required_argument, nullptr, 'a'},
                 {"layout", required_argument, nullptr, 'l'},
+                {"layout-cache", required_argument, nullptr, 'k'},
                 {"log", required_argument, nullptr, 'g'},
+                {"max-frames", required_argument, nullptr, 'm'},
                 {"help", no_argument, nullptr, 'h'},
+                {"jobs", required_argument, nullptr, 'j'},
                 {"verbose", no_argument, nullptr, 'v'},
                 {nullptr, no_argument, nullptr, 0}
         };
@@ -72,9 +96,27 @@ void process_args(int argc, char** argv)
                 case 'e':
                         Option::extension = optarg;
                 break;
+                case 'a':
+                        Option::gif_file = optarg;
+                break;
+                case 't':
+                        Option::delay = optarg;
+                break;
+                case 'j':
+                        Option::jobs = optarg;
+                break;
+                case 'n':
+                        Option::every = optarg;
+                break;
+                case 'm':
+                        Option::max_frames = optarg;
+                break;
                 case 'l':
                         Option::layout = optarg;
                 break;
+                case 'k':
+                        Option::layout_cache = optarg;
+                break;
                 case 'v':
                         Option::should_output = true;
                 break;
@@ -112,6 +154,36 @@ void process_args(int argc, char** argv)
                         exit(0);
                 }
 
+        // check if delay is a number
+        if (Option::delay == "" or !std::all_of(Option::delay.begin(), Option::delay.end(),
+                        [] (char ch) { return std::isdigit(ch); })) {
+                std::cerr << "delay is not numeric value: " << Option::delay << "\n";
+                exit(0);
+        }
+
+        // check if number of jobs is a positive number
+        if (Option::jobs == "" or Option::jobs.size() > 9
+                        or !std::all_of(Option::jobs.begin(), Option::jobs.end(),
+                                [] (char ch) { return std::isdigit(ch); })
+                        or std::stoul(Option::jobs) == 0) {
+                std::cerr << "jobs is not positive numeric value: " << Option::jobs << "\n";
+                exit(0);
+        }
+
+        // check if sampling values are numbers, parse them once
+        auto parse_sampling = [] (const std::string& value) -> size_t {
+                if (value == "" or value.size() > 9 or !std::all_of(value.begin(), value.end(),
+                                [] (char ch) { return std::isdigit(ch); })) {
+                        std::cerr << "sampling value is not numeric value: " << value << "\n";
+                        exit(0);
+                }
+
+                return std::stoul(value);
+        };
+
+        Option::sample_every = parse_sampling(Option::every);
+        Option::frames_limit = parse_sampling(Option::max_frames);
+
         std::vector<std::string> layouts = {"dot", "neato",
                 "fdp", "sfdp", "twopi", "circo"};
 
@@ -145,12 +217,41 @@ int main(int argc, char** argv)
                 return 0;
         }
 
-        gviz::graphviz_context context(cgraph, Option::layout);
+        gviz::graphviz_context context;
+
+        if (Option::layout_cache != "") {
+                try {
+                        if (gviz::set_cached_layout(context, cgraph, Option::layout, Option::layout_cache)
+                                        and Option::should_output)
+                                out() << "Layout loaded from: " << Option::layout_cache << "\n";
+                } catch (std::exception& e) {
+                        out() << e.what() << "\n";
+                        return 0;
+                }
+        } else {
+                context.set_layout(cgraph, Option::layout);
+        }
 
         grlib::adj_list<grlib::Basic_edge> alist(cgraph);
 
-        gviz::render(context, cgraph, "0", Option::extension);
-        int frame_number = 1;
+        std::unique_ptr<gviz::gif_animation> animation;
+
+        if (Option::gif_file != "") {
+                try {
+                        animation = std::make_unique<gviz::gif_animation>(Option::gif_file,
+                                        std::stoul(Option::delay));
+                } catch (std::exception& e) {
+                        out() << e.what() << "\n";
+                        return 0;
+                }
+        }
+
+        // callbacks record changes of attributes, frames are rendered in parallel at the end
+        gviz::frame_recorder recorder;
+
+        gviz::Attribute fillcolor(cgraph, AGNODE, "fillcolor");
+
+        recorder.frame();
 
         std::vector<int> sorted;
         try {
@@ -172,17 +273,43 @@ int main(int argc, char** argv)
         }
 
         for (auto p = sorted.rbegin(); p != sorted.rend(); p++) {
-                gviz::Node node(cgraph.find_node(alist.vmap.names[*p]));
+                gviz::Node node(alist.vmap.node(*p));
 
-                if (!node.set_attr("fillcolor", "#ff4000")) {
+                if (!recorder.set_attr(node, fillcolor, "#ff4000")) {
                         continue;
                 }
 
-                try {
-                        gviz::render(context, cgraph, std::to_string(frame_number++), Option::extension);
-                } catch (std::exception& e) {
-                        out() << e.what() << "\n";
-                }
+                recorder.frame();
+        }
+
+        // steps which did not change anything are skipped already, long animations are sampled
+        recorder.sample(Option::sample_every);
+
+        if (Option::frames_limit > 0)
+                recorder.limit(Option::frames_limit);
+
+        if (Option::should_output)
+                out() << "Rendering " << recorder.frames_number() << " frames\n";
+
+        try {
+                std::vector<size_t> failed = animation
+                        ? gviz::render_frames(context, cgraph, recorder, *animation,
+                                        std::stoul(Option::jobs))
+                        : gviz::render_frames(context, cgraph, recorder, Option::extension,
+                                        std::stoul(Option::jobs));
+
+                for (size_t frame : failed)
+                        out() << "Rendering frame " << frame << " failed\n";
+        } catch (std::exception& e) {
+                out() << e.what() << "\n";
+        }
+
+        // frames rendered before an error still make a valid animation
+        try {
+                if (animation)
+                        animation->close();
+        } catch (std::exception& e) {
+                out() << e.what() << "\n";
         }
 
         return 0;
@@ -0,0 +1,84 @@
+/** @file */
+#pragma once
+
+#include <string>
+#include <gvc.h>
+
+#include "graphviz/cgraph.hpp"
+#include "graphviz/object.hpp"
+
+namespace gviz {
+
+/**
+ * Handle of attribute declared in a graph. Object::set_attr() looks the attribute up by
+ * name on every call; a handle is looked up once, then setting and getting values are
+ * direct accesses to the object's attribute record.
+ */
+class Attribute {
+    public:
+        /**
+         * Initialize the attribute to invalid state (check it with operator!())
+         */
+        Attribute();
+
+        /**
+         * Find attribute declared in the graph. On fail, attribute is in invalid state
+         * (check it with operator!())
+         * @param graph: graph declaring the attribute
+         * @param obj_type: type of Graphviz object: AGRAPH, AGNODE or AGEDGE
+         * @param name: name of the attribute
+         */
+        Attribute(cgraph& graph, int obj_type, const std::string& name);
+
+        /**
+         * Find attribute declared in the graph, declare it when it is not defined.
+         * On fail, attribute is in invalid state (check it with operator!())
+         * @param graph: graph declaring the attribute
+         * @param obj_type: type of Graphviz object: AGRAPH, AGNODE or AGEDGE
+         * @param name: name of the attribute
+         * @param default_value: default value the attribute will have for object class
+         */
+        Attribute(cgraph& graph, int obj_type, const std::string& name,
+                        const std::string& default_value);
+
+        /**
+         * @return bool indicating whether Attribute is in invalid state (it is NULL)
+         */
+        bool operator!() const;
+
+        /**
+         * @return bool indicating whether Attribute is in valid state (it is non-NULL)
+         */
+        operator bool() const;
+
+        /**
+         * @return name of the attribute
+         */
+        std::string name() const;
+
+        /**
+         * Set the attribute of the object
+         * @param object: node, edge or graph of the attribute's type
+         * @param value: value to be set
+         * @return bool indicating whether attribute is applied
+         */
+        bool set(Object& object, const std::string& value) const;
+
+        /**
+         * Get the attribute of the object
+         * @param object: node, edge or graph of the attribute's type
+         * @return string with attribute value or throws the exception
+         * if attribute is invalid
+         */
+        std::string get(const Object& object) const;
+
+        /**
+         * @return internal pointer to the attribute symbol
+         */
+        Agsym_t* data() const;
+
+    private:
+        Agsym_t* sym;
+};
+
+}; // namespace gviz
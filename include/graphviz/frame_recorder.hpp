@@ -0,0 +1,153 @@
+/** @file */
+#pragma once
+
+#include <gvc.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "graphviz/attribute.hpp"
+#include "graphviz/cgraph.hpp"
+#include "graphviz/gif.hpp"
+#include "graphviz/graphviz_context.hpp"
+#include "graphviz/object.hpp"
+
+namespace gviz {
+
+/**
+ * Records attribute changes made by an algorithm, step by step, so frames can be rendered
+ * after the algorithm finishes and in parallel. Changes are applied to the graph at once,
+ * so the algorithm reads attributes it set; frame() marks the end of a step, which
+ * replaces rendering inside the callbacks. Changes which do not change the value are
+ * not recorded, and a frame showing the same attributes as the previous one is skipped.
+ */
+class frame_recorder {
+    public:
+        frame_recorder() = default;
+
+        /**
+         * Set object's attribute and record the change, see Object::set_attr()
+         * @param object: node, edge or graph
+         * @param attr: name of the attribute
+         * @param value: value to be set
+         * @return bool indicating whether attribute is applied
+         */
+        bool set_attr(Object& object, const std::string& attr, const std::string& value);
+
+        /**
+         * Set object's attribute and record the change, see Object::set_attr_safe()
+         * @param object: node, edge or graph
+         * @param attr: name of the attribute
+         * @param value: value to be set
+         * @param default_value: default value the attribute will have for object class (nodes, edges)
+         * @return bool indicating whether attribute is applied
+         */
+        bool set_attr_safe(Object& object, const std::string& attr, const std::string& value,
+                        const std::string& default_value);
+
+        /**
+         * Set object's attribute and record the change, see Attribute::set()
+         * @param object: node, edge or graph
+         * @param attribute: handle of the attribute
+         * @param value: value to be set
+         * @return bool indicating whether attribute is applied
+         */
+        bool set_attr(Object& object, const Attribute& attribute, const std::string& value);
+
+        /**
+         * End the frame: it shows the graph with all changes recorded so far. The frame is
+         * not added when attributes are the same as in the previous frame, e.g. nothing
+         * was changed or changes were reverted.
+         * @return bool indicating whether the frame was added
+         */
+        bool frame();
+
+        /**
+         * Keep every n-th frame and the last one. Changes of dropped frames are shown by
+         * the next kept frame, so a long animation coalesces steps.
+         * @param every: distance of kept frames
+         */
+        void sample(size_t every);
+
+        /**
+         * Keep at most max_frames frames evenly spaced, including the first and the last one,
+         * see sample()
+         * @param max_frames: number of kept frames
+         */
+        void limit(size_t max_frames);
+
+        /**
+         * @return number of frames
+         */
+        size_t frames_number() const;
+
+        /**
+         * @return hash of attributes after all recorded changes, equal for equal attributes
+         * regardless of the order of changes
+         */
+        std::uint64_t state_hash() const;
+
+        /**
+         * Set attributes of the graph to the state shown by the frame
+         * @param frame: index of the frame
+         */
+        void seek(size_t frame);
+
+        /**
+         * Set attributes of the graph to the state after all recorded changes
+         */
+        void seek_end();
+
+    private:
+        struct attribute_change {
+                Agobj_t* obj;
+                Agsym_t* sym;
+                std::string old_value;
+                std::string new_value;
+        };
+
+        bool record(Agobj_t* obj, Agsym_t* sym, const std::string& value);
+        bool same_as_last_frame() const;
+        void move_to(size_t position);
+
+        std::vector<attribute_change> changes;
+        std::vector<size_t> frames; /// number of changes shown by each frame
+        size_t position = 0; /// number of changes applied to the graph
+        std::uint64_t hash = 0; /// xor of hashes of changed values, 0 for initial attributes
+        std::uint64_t last_frame_hash = 0;
+};
+
+/**
+ * Render recorded frames into files named after frame numbers, like "0.png", "1.png".
+ * Frames are split between worker processes: libgvc keeps global state, so it cannot
+ * render in several threads, while a forked process gets its own copy of the graph
+ * and the layout. After rendering the graph is in the state after all changes.
+ * A frame which fails to render is skipped and the others are still rendered; the
+ * exception is thrown only when workers cannot be started or stop working.
+ * @param context: context with layout of the graph
+ * @param graph: graph the frames were recorded on
+ * @param recorder: recorded frames
+ * @param extension: format of the files
+ * @param workers: number of processes rendering frames, 1 renders in this process
+ * @return indexes of frames which were not rendered
+ */
+std::vector<size_t> render_frames(graphviz_context& context, cgraph& graph, frame_recorder& recorder,
+                const std::string& extension, unsigned workers);
+
+/**
+ * Render recorded frames in worker processes and add them to the animation in order,
+ * see render_frames() above. Workers wait while their frame is not taken yet, so memory
+ * use does not depend on the number of frames. A frame which fails to render is left
+ * out of the animation.
+ * @param context: context with layout of the graph
+ * @param graph: graph the frames were recorded on
+ * @param recorder: recorded frames
+ * @param animation: animation receiving the frames
+ * @param workers: number of processes rendering frames, 1 renders in this process
+ * @return indexes of frames which were not rendered
+ */
+std::vector<size_t> render_frames(graphviz_context& context, cgraph& graph, frame_recorder& recorder,
+                gif_animation& animation, unsigned workers);
+
+}; // namespace gviz
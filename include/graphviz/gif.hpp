@@ -0,0 +1,106 @@
+/** @file */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "graphviz/cgraph.hpp"
+#include "graphviz/graphviz_context.hpp"
+
+namespace gviz {
+
+/**
+ * Image with pixels stored row by row in 0xRRGGBB format
+ */
+struct rgb_image {
+        size_t width = 0;
+        size_t height = 0;
+        std::vector<std::uint32_t> pixels;
+};
+
+/**
+ * Decode image in libgd "gd" format, which Graphviz renders with format "gd".
+ * Both truecolor and palette images are supported, transparency is blended with white.
+ * @param data: content of the image
+ * @param image: receives decoded image, its buffer is reused
+ */
+void decode_gd(const std::vector<char>& data, rgb_image& image);
+
+/**
+ * Animated GIF written frame by frame, so memory use does not depend on the number
+ * of frames. Only the rectangle that differs from the previous frame is stored, pixels
+ * which did not change inside it are transparent. Every frame has its own palette:
+ * exact when the rectangle has at most 255 colors, otherwise the 255 most frequent ones.
+ * Frames equal to the previous one only extend its delay.
+ */
+class gif_animation {
+    public:
+        /**
+         * Create the file
+         * @param file_name: name of the file
+         * @param delay: time each frame is shown, in hundredths of a second
+         * @param loops: number of repetitions, 0 is infinite
+         */
+        gif_animation(const std::string& file_name, unsigned delay = 50, unsigned loops = 0);
+
+        gif_animation(const gif_animation& other) = delete;
+        gif_animation(gif_animation&& other) = delete;
+        void operator=(const gif_animation& other) = delete;
+        void operator=(gif_animation&& other) = delete;
+
+        ~gif_animation();
+
+        /**
+         * Append frame, all frames must have the same size
+         * @param frame: image of the frame
+         */
+        void add_frame(const rgb_image& frame);
+
+        /**
+         * Append frame encoded in gd format, see decode_gd()
+         * @param data: content of the image
+         */
+        void add_gd_frame(const std::vector<char>& data);
+
+        /**
+         * Write the last frame and close the file; called by the destructor as well
+         */
+        void close();
+
+        /**
+         * @return number of frames added, including ones merged with previous frame
+         */
+        size_t frames_number() const;
+
+        friend void render(graphviz_context& context, cgraph& graph, gif_animation& animation);
+
+    private:
+        void write_pending();
+        void encode(const rgb_image& frame, bool delta, size_t left, size_t top,
+                        size_t width, size_t height);
+
+        FILE* file;
+        unsigned delay;
+        unsigned loops;
+        size_t frames;
+
+        rgb_image previous; /// last frame added
+        rgb_image current; /// buffer of decoded gd frames
+        std::vector<char> render_buffer; /// buffer of rendered gd frames
+
+        std::vector<std::uint8_t> pending; /// encoded last frame, written when its delay is known
+        unsigned pending_delay;
+        size_t pending_delay_pos; /// position of the delay in pending
+};
+
+/**
+ * Render graph as the next frame of the animation
+ * @param context: context with layout of the graph
+ * @param graph: graph to be rendered
+ * @param animation: animation receiving the frame
+ */
+void render(graphviz_context& context, cgraph& graph, gif_animation& animation);
+
+}; // namespace gviz
@@ -3,6 +3,9 @@
 
 #include <gvc.h>
 
+#include <string>
+#include <vector>
+
 #include "graphviz/cgraph.hpp"
 
 namespace gviz {
@@ -14,6 +17,13 @@ class graphviz_context {
 
         void set_layout(cgraph& graph, const std::string& layout);
 
+        /**
+         * Free layout of the graph, needed before the graph is closed when the context
+         * lays out many graphs, e.g. detail tiles
+         * @param graph: graph laid out by the context
+         */
+        void free_layout(cgraph& graph);
+
         graphviz_context(const graphviz_context& other) = delete;
         graphviz_context(graphviz_context&& other) = delete;
         void operator=(const graphviz_context& other) = delete;
@@ -30,5 +40,23 @@ class graphviz_context {
 void render(graphviz_context& context, cgraph& graph, const std::string& file_name,
                 const std::string& extension);
 
+/**
+ * Render graph into memory, so frames can be passed on without touching the filesystem.
+ * @param context: context with layout of the graph
+ * @param graph: graph to be rendered
+ * @param format: output format, e.g. "png", "gd", "svg"
+ * @param buffer: receives the data; its capacity is kept, so rendering following frames
+ * into the same buffer does not reallocate it
+ * @return size of the data
+ */
+size_t render_to_memory(graphviz_context& context, cgraph& graph, const std::string& format,
+                std::vector<char>& buffer);
+
+/**
+ * Render graph into a new buffer, see render_to_memory() above
+ */
+std::vector<char> render_to_memory(graphviz_context& context, cgraph& graph,
+                const std::string& format);
+
 }; // namespace gviz
 
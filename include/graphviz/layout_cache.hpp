@@ -0,0 +1,37 @@
+/** @file */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "graphviz/cgraph.hpp"
+#include "graphviz/graphviz_context.hpp"
+
+namespace gviz {
+
+/**
+ * Hash identifying the layout of the graph: FNV-1a of the graph written in dot format
+ * (with all its attributes) and of the layout name.
+ * @param graph: graph to be laid out
+ * @param layout: layout name
+ * @return 64-bit hash
+ */
+std::uint64_t layout_hash(cgraph& graph, const std::string& layout);
+
+/**
+ * Lay out the graph, reusing positions computed before for the same graph and layout.
+ * Positions of nodes and edge splines are kept in the cache directory, in a file named
+ * after layout_hash(). When the file exists, positions are restored and the graph is
+ * laid out with "nop2", which keeps them as they are (like neato -n2), so the expensive
+ * layout runs once per graph. Cache which cannot be written is skipped, the layout is
+ * computed anyway.
+ * @param context: context receiving the layout
+ * @param graph: graph to be laid out
+ * @param layout: layout name, see graphviz_context::set_layout()
+ * @param cache_dir: existing directory with cached layouts
+ * @return bool indicating whether layout was loaded from the cache
+ */
+bool set_cached_layout(graphviz_context& context, cgraph& graph, const std::string& layout,
+                const std::string& cache_dir);
+
+}; // namespace gviz
@@ -82,6 +82,9 @@ class Object {
                         const std::string& default_value);
     protected:
         Agobj_t* obj; /// pointer to the base object
+
+        friend class Attribute;
+        friend class frame_recorder;
 };
 
 }; // namespace gviz
@@ -0,0 +1,47 @@
+/** @file */
+#pragma once
+
+#include <gvc.h>
+
+#include <string>
+#include <vector>
+
+#include "graphviz/cgraph.hpp"
+
+namespace gviz {
+
+/**
+ * Set graph attributes which keep sfdp fast on graphs with many thousands of nodes:
+ * multilevel layout with Barnes-Hut approximation of repulsive forces, overlaps removed
+ * by prism and straight edges drawn below nodes, so no splines are routed.
+ * @param graph: graph to be laid out
+ * @return bool indicating whether attributes are applied
+ */
+bool set_large_graph_attrs(cgraph& graph);
+
+/**
+ * Overview of the graph: every group of nodes becomes a single node named after its label,
+ * and edges between groups are merged into a single edge weighted by their number.
+ * Nodes are sized by the number of members kept in the "members" attribute. When there
+ * are more groups than max_nodes, the largest ones are kept and the rest is merged into
+ * a node named "other", so the overview stays small regardless of the graph size.
+ * @param graph: graph of the nodes
+ * @param nodes: node of each vertex, see Vertices_map::nodes
+ * @param labels: label of each vertex numbered from 1, -1 for vertices outside of groups
+ * (as sccs_context::scc), such vertices are skipped
+ * @param max_nodes: upper limit of overview's nodes, 0 keeps all groups
+ * @return overview graph, directed when graph is directed
+ */
+cgraph quotient_graph(cgraph& graph, const std::vector<Agnode_t*>& nodes,
+                const std::vector<int>& labels, size_t max_nodes);
+
+/**
+ * Detail of the graph: copy of the nodes and edges between them with their attributes
+ * @param graph: graph of the nodes
+ * @param nodes: nodes to be copied
+ * @param name: name of the new graph
+ * @return graph of the same type as graph
+ */
+cgraph induced_graph(cgraph& graph, const std::vector<Agnode_t*>& nodes, const std::string& name);
+
+}; // namespace gviz
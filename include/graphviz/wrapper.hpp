@@ -1,11 +1,16 @@
 /** @file */
 #pragma once
 
+#include "graphviz/attribute.hpp"
 #include "graphviz/cgraph.hpp"
 #include "graphviz/edge.hpp"
 #include "graphviz/edge_iterator.hpp"
+#include "graphviz/frame_recorder.hpp"
 #include "graphviz/node.hpp"
 #include "graphviz/node_iterator.hpp"
 #include "graphviz/object.hpp"
 #include "graphviz/graphviz_context.hpp"
+#include "graphviz/gif.hpp"
+#include "graphviz/layout_cache.hpp"
+#include "graphviz/overview.hpp"
 
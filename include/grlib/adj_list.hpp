@@ -1,10 +1,16 @@
 /** @file */
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
-#include <vector>
 #include <list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
+#include "grlib/parallel.hpp"
 #include "grlib/rep_base.hpp"
 
 namespace grlib {
@@ -18,32 +24,59 @@ struct Basic_edge {
         int weight; /// weight of the edge
 };
 
-template<typename Edge>
+/**
+ * Options of adjacency list construction, see adj_list::insert_edges()
+ */
+struct adj_list_options {
+        bool dedupe = false; /// sort neighbors ascending and keep only the first of multiple edges
+        bool drop_self_loops = false; /// skip inserted x -> x edges
+        unsigned threads = 1; /// number of threads filling the lists
+};
+
+/**
+ * Adjacency list. List nodes are taken from Alloc, e.g. grlib::arena_allocator to build
+ * big graphs without a heap allocation per edge; all lists share a copy of one allocator.
+ */
+template<typename Edge, typename Alloc = std::allocator<Edge>>
 struct adj_list : public Representation_base {
         static constexpr size_t default_capacity = CONFIG_ADJ_LIST_DEFAULT_CAP;
 
+        using list_type = std::list<Edge, Alloc>;
+
         adj_list();
 
         /**
          * Define graph attribute
          * @param size: number/range of preallocated nodes
          * @param directed: whether graph is directed
+         * @param alloc: allocator of list nodes
          */
-        adj_list(size_t size, bool directed = false);
+        adj_list(size_t size, bool directed = false, const Alloc& alloc = Alloc());
 
 #ifdef GRLIB_SYNC_WITH_GRAPHVIZ
         /**
          * Initialize adjacency list using graph structure
          * @param cgraph: Graphviz graph
+         * @param alloc: allocator of list nodes
+         */
+        adj_list(gviz::cgraph& cgraph, const Alloc& alloc = Alloc());
+
+        /**
+         * Initialize adjacency list using graph structure
+         * @param cgraph: Graphviz graph
+         * @param options: e.g. removal of multiple edges, which undirected multigraph
+         * would otherwise keep in both directions
+         * @param alloc: allocator of list nodes
          */
-        adj_list(gviz::cgraph& cgraph);
+        adj_list(gviz::cgraph& cgraph, const adj_list_options& options,
+                        const Alloc& alloc = Alloc());
 #endif
         /**
          * Insert x -> y edge into adjacency list
          * @param x: index of first vertex
          * @param edge: weight structure of the graph
          */
-        void insert_edge(grlib::vertex_id x, Edge& edge);
+        void insert_edge(grlib::vertex_id x, const Edge& edge);
 
         /**
          * Insert x -> y edge into adjacency list
@@ -52,79 +85,226 @@ struct adj_list : public Representation_base {
          */
         void insert_edge(grlib::vertex_id x, Edge&& edge);
 
+        /**
+         * Insert many edges at once. Degrees are counted first, so the vertex range grows
+         * once and edges of each vertex are appended by a single thread, moved from arcs.
+         * As with insert_edge(), undirected graph needs both x -> y and y -> x.
+         * @param arcs: pairs of the first vertex and the edge
+         * @param threads: number of threads filling the lists, only stateless allocators
+         * are used concurrently (arena_allocator is not thread-safe)
+         */
+        void insert_edges(std::vector<std::pair<grlib::vertex_id, Edge>> arcs,
+                        unsigned threads = 1);
+
+        /**
+         * Insert many edges at once, see insert_edges() above. With options.dedupe whole
+         * neighbor lists of touched vertices are sorted and deduplicated, edges_number()
+         * counts the unique edges.
+         * @param arcs: pairs of the first vertex and the edge
+         * @param options: construction options
+         */
+        void insert_edges(std::vector<std::pair<grlib::vertex_id, Edge>> arcs,
+                        const adj_list_options& options);
+
         size_t vertices_capacity() const;
 
-        std::vector<std::list<Edge>> edges; /// adjacency list - list of edges of each edge
+        /**
+         * @return range of vertices in use: up to the last vertex named in vmap or having
+         * an edge; preallocated slots beyond it are not vertices
+         */
+        size_t vertices_number() const;
+
+        Alloc allocator; /// copied into every list
+        std::vector<list_type> edges; /// adjacency list - list of edges of each edge
 };
 
-template<typename Edge>
-adj_list<Edge>::adj_list()
-: Representation_base(default_capacity, false, 0UL),
-  edges(default_capacity)
+template<typename Edge, typename Alloc>
+adj_list<Edge, Alloc>::adj_list()
+: adj_list<Edge, Alloc>(default_capacity)
 {
 }
 
-template<typename Edge>
-adj_list<Edge>::adj_list(size_t size, bool directed)
+template<typename Edge, typename Alloc>
+adj_list<Edge, Alloc>::adj_list(size_t size, bool directed, const Alloc& alloc)
 : Representation_base(size, directed, 0UL),
-  edges(size)
+  allocator(alloc),
+  edges(size, list_type(alloc))
 {
 }
 
 #ifdef GRLIB_SYNC_WITH_GRAPHVIZ
 
-template<typename Edge>
-adj_list<Edge>::adj_list(gviz::cgraph& cgraph)
-: adj_list<Edge>(cgraph.nodes_number(), cgraph.is_directed())
+template<typename Edge, typename Alloc>
+adj_list<Edge, Alloc>::adj_list(gviz::cgraph& cgraph, const Alloc& alloc)
+: adj_list<Edge, Alloc>(cgraph, adj_list_options(), alloc)
+{
+}
+
+template<typename Edge, typename Alloc>
+adj_list<Edge, Alloc>::adj_list(gviz::cgraph& cgraph, const adj_list_options& options,
+                const Alloc& alloc)
+: adj_list<Edge, Alloc>(cgraph.nodes_number(), cgraph.is_directed(), alloc)
 {
-        for (const auto& node : cgraph)
-                vmap.push(node.name());
+        for (gviz::Node node : cgraph)
+                vmap.push(node.name(), node.data());
+
+        // edge weights are taken from "weight" attribute when graph declares it
+        bool weighted = true;
+        try {
+                cgraph.find_edge_attr("weight");
+        } catch (std::runtime_error& e) {
+                weighted = false;
+        }
+
+        std::vector<std::pair<grlib::vertex_id, Edge>> arcs;
 
         grlib::vertex_id x, y;
+        int weight;
         for (gviz::Node node : cgraph)
                 for (gviz::Edge edge : node) {
                         x = vmap.index(edge.tail().name());
                         y = vmap.index(edge.head().name());
+                        weight = weighted ? std::atoi(edge.get_attr("weight").c_str()) : 0;
 
-                        insert_edge(x, Edge(y, 0));
+                        arcs.emplace_back(x, Edge(y, weight));
 
                         if (!cgraph.is_directed())
-                                insert_edge(y, Edge(x, 0));
+                                arcs.emplace_back(y, Edge(x, weight));
                 }
+
+        insert_edges(std::move(arcs), options);
 }
 
 #endif
 
-template<typename Edge>
-void adj_list<Edge>::insert_edge(grlib::vertex_id x, Edge& edge)
+template<typename Edge, typename Alloc>
+void adj_list<Edge, Alloc>::insert_edge(grlib::vertex_id x, const Edge& edge)
 {
+        // vector grows geometrically, resizing to the exact range is amortized O(1)
         if (x + 1 > (int)edges.size())
-                edges.resize(2 * x);
+                edges.resize(x + 1, list_type(allocator));
 
         edges[x].push_back(edge);
 
         enumber++;
 }
 
-template<typename Edge>
-void adj_list<Edge>::insert_edge(grlib::vertex_id x, Edge&& edge)
+template<typename Edge, typename Alloc>
+void adj_list<Edge, Alloc>::insert_edge(grlib::vertex_id x, Edge&& edge)
 {
         if (x + 1 > (int)edges.size())
-                edges.resize(2 * x);
+                edges.resize(x + 1, list_type(allocator));
 
-        edges[x].emplace_back(edge);
+        edges[x].push_back(std::move(edge));
 
         enumber++;
 }
 
-template<typename Edge>
-size_t adj_list<Edge>::vertices_capacity() const
+template<typename Edge, typename Alloc>
+void adj_list<Edge, Alloc>::insert_edges(std::vector<std::pair<grlib::vertex_id, Edge>> arcs,
+                unsigned threads)
+{
+        adj_list_options options;
+        options.threads = threads;
+        insert_edges(std::move(arcs), options);
+}
+
+template<typename Edge, typename Alloc>
+void adj_list<Edge, Alloc>::insert_edges(std::vector<std::pair<grlib::vertex_id, Edge>> arcs,
+                const adj_list_options& options)
+{
+        size_t n = edges.size();
+        for (const auto& arc : arcs)
+                n = std::max<size_t>(n, std::max(arc.first, arc.second.y) + 1);
+
+        if (n > edges.size())
+                edges.resize(n, list_type(allocator));
+
+        // counting sort of arcs by the first vertex, stable; nodes of a list are then
+        // allocated one after another, which helps later traversals
+        std::vector<size_t> offsets(n + 1, 0);
+        for (const auto& arc : arcs)
+                offsets[arc.first + 1]++;
+
+        for (size_t v = 0; v < n; v++)
+                offsets[v + 1] += offsets[v];
+
+        std::vector<Edge> sorted(arcs.size());
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+
+        for (auto& arc : arcs)
+                sorted[next[arc.first]++] = std::move(arc.second);
+
+        unsigned threads = options.threads;
+        if (!std::allocator_traits<Alloc>::is_always_equal::value)
+                threads = 1;
+
+        auto bounds = grlib::partition_by_edges(offsets, threads);
+        // negative when duplicates inserted earlier are removed
+        std::vector<long> added(bounds.size() - 1, 0);
+
+        auto by_target = [] (const Edge& a, const Edge& b) { return a.y < b.y; };
+
+        grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                grlib::vertex_id end) {
+                for (grlib::vertex_id v = begin; v < end; v++) {
+                        size_t first = offsets[v], last = offsets[v + 1];
+                        list_type& list = edges[v];
+                        size_t before = list.size();
+
+                        if (options.dedupe)
+                                std::stable_sort(sorted.begin() + first, sorted.begin() + last, by_target);
+
+                        grlib::vertex_id previous = -1;
+
+                        for (size_t k = first; k < last; k++) {
+                                grlib::vertex_id y = sorted[k].y;
+
+                                if (options.drop_self_loops and y == v)
+                                        continue;
+
+                                // duplicates are adjacent after sorting
+                                if (options.dedupe and y == previous)
+                                        continue;
+
+                                previous = y;
+                                list.push_back(std::move(sorted[k]));
+                        }
+
+                        // merge with edges inserted before, the older edge wins
+                        if (options.dedupe and before > 0 and last > first) {
+                                list.sort(by_target);
+                                list.unique([] (const Edge& a, const Edge& b) { return a.y == b.y; });
+                        }
+
+                        added[part] += static_cast<long>(list.size()) - static_cast<long>(before);
+                }
+        });
+
+        for (long count : added)
+                enumber += count;
+}
+
+template<typename Edge, typename Alloc>
+size_t adj_list<Edge, Alloc>::vertices_capacity() const
 {
         return edges.size();
 }
 
-template<typename Edge>
-void print_adj_list(adj_list<Edge>& list)
+template<typename Edge, typename Alloc>
+size_t adj_list<Edge, Alloc>::vertices_number() const
+{
+        size_t n = std::min(vmap.max_index, edges.size());
+
+        for (size_t v = 0; v < edges.size(); v++)
+                for (const auto& edge : edges[v])
+                        n = std::max<size_t>(n, std::max<size_t>(v, edge.y) + 1);
+
+        return n;
+}
+
+template<typename Edge, typename Alloc>
+void print_adj_list(adj_list<Edge, Alloc>& list)
 {
         std::cout << "-------------------\n";
 
@@ -0,0 +1,205 @@
+/** @file */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace grlib {
+
+/**
+ * Monotonic memory arena with fixed-size block pools. Memory is taken from the system
+ * in chunks and given back all at once when the arena is destroyed or released, so
+ * a graph of N edges costs O(N / chunk) allocations. Small blocks freed earlier are kept
+ * on a free list of their size and reused; node based containers allocate blocks of
+ * one size only, so a graph that keeps changing does not grow the arena. When the last
+ * block is freed the arena is released, so a rebuilt graph gets sequential memory again.
+ * Not thread-safe: an arena belongs to structures modified by one thread at a time.
+ */
+class arena {
+public:
+        static constexpr size_t default_chunk = 64 * 1024;
+        static constexpr size_t granularity = alignof(std::max_align_t);
+        static constexpr size_t max_pooled = 512; /// bigger blocks are never reused
+
+        /**
+         * @param chunk_bytes: size of memory chunks taken from the system
+         */
+        explicit arena(size_t chunk_bytes = default_chunk)
+        : chunk_bytes(chunk_bytes < max_pooled ? max_pooled : chunk_bytes),
+          free_lists(max_pooled / granularity + 1, nullptr) { }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena() { release(); }
+
+        /**
+         * @param bytes: size of the block
+         * @param align: alignment of the block
+         * @return uninitialized block of memory
+         */
+        void* allocate(size_t bytes, size_t align = granularity)
+        {
+                bytes = round_up(bytes == 0 ? 1 : bytes, granularity);
+                live++;
+
+                if (bytes <= max_pooled and align <= granularity) {
+                        free_block*& head = free_lists[bytes / granularity];
+
+                        if (head) {
+                                free_block* block = head;
+                                head = block->next;
+                                return block;
+                        }
+                }
+
+                // blocks that would waste most of a chunk get a chunk of their own
+                if (bytes > chunk_bytes / 4) {
+                        char* memory = new_chunk(bytes + align);
+                        size_t address = reinterpret_cast<size_t>(memory);
+                        return memory + (round_up(address, align) - address);
+                }
+
+                size_t start = round_up(used, align);
+
+                if (!current or start + bytes > chunk_bytes) {
+                        current = new_chunk(chunk_bytes);
+                        start = 0;
+                }
+
+                used = start + bytes;
+                return current + start;
+        }
+
+        /**
+         * Return block to the pool of its size. Big blocks stay allocated until release()
+         * or until all blocks are freed.
+         * @param p: block returned by allocate()
+         * @param bytes: size passed to allocate()
+         * @param align: alignment passed to allocate()
+         */
+        void deallocate(void* p, size_t bytes, size_t align = granularity)
+        {
+                bytes = round_up(bytes == 0 ? 1 : bytes, granularity);
+
+                if (--live == 0) {
+                        release();
+                        return;
+                }
+
+                if (bytes > max_pooled or align > granularity)
+                        return;
+
+                free_block* block = static_cast<free_block*>(p);
+                block->next = free_lists[bytes / granularity];
+                free_lists[bytes / granularity] = block;
+        }
+
+        /**
+         * Give all memory back to the system. Blocks allocated before must not be used.
+         */
+        void release()
+        {
+                chunks.clear();
+                std::fill(free_lists.begin(), free_lists.end(), nullptr);
+                current = nullptr;
+                used = 0;
+                reserved = 0;
+                live = 0;
+        }
+
+        /**
+         * @return number of chunks taken from the system
+         */
+        size_t chunks_number() const { return chunks.size(); }
+
+        /**
+         * @return bytes taken from the system
+         */
+        size_t bytes_reserved() const { return reserved; }
+
+private:
+        struct free_block {
+                free_block* next;
+        };
+
+        struct chunk_deleter {
+                void operator()(char* p) const { ::operator delete(p); }
+        };
+
+        static size_t round_up(size_t value, size_t align)
+        {
+                return (value + align - 1) / align * align;
+        }
+
+        char* new_chunk(size_t bytes)
+        {
+                chunks.emplace_back(static_cast<char*>(::operator new(bytes)));
+                reserved += bytes;
+                return chunks.back().get();
+        }
+
+        size_t chunk_bytes;
+        char* current = nullptr; /// chunk used for bump allocation
+        size_t used = 0; /// bytes used in the current chunk
+        size_t reserved = 0;
+        size_t live = 0; /// blocks allocated and not freed yet
+        std::vector<std::unique_ptr<char, chunk_deleter>> chunks;
+        std::vector<free_block*> free_lists; /// index: block size / granularity
+};
+
+/**
+ * Standard allocator taking memory from a shared arena. Copies (and rebound copies used
+ * by containers for their nodes) share the arena, which lives as long as any of them.
+ * Pass one allocator to all containers of a graph, e.g. adj_list(size, directed, alloc);
+ * a default constructed allocator creates a new arena.
+ */
+template<typename T>
+struct arena_allocator {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        arena_allocator()
+        : resource(std::make_shared<grlib::arena>()) { }
+
+        /**
+         * @param resource: arena providing the memory
+         */
+        explicit arena_allocator(std::shared_ptr<grlib::arena> resource)
+        : resource(std::move(resource)) { }
+
+        template<typename U>
+        arena_allocator(const arena_allocator<U>& other)
+        : resource(other.resource) { }
+
+        T* allocate(size_t n)
+        {
+                return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+                resource->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        // friends are found only by argument lookup, so they don't hide other operators
+        friend bool operator==(const arena_allocator& a, const arena_allocator& b)
+        {
+                return a.resource == b.resource;
+        }
+
+        friend bool operator!=(const arena_allocator& a, const arena_allocator& b)
+        {
+                return a.resource != b.resource;
+        }
+
+        std::shared_ptr<grlib::arena> resource;
+};
+
+}; // namespace grlib
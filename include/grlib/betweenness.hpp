@@ -0,0 +1,183 @@
+/** @file */
+#pragma once
+
+#include "grlib/bfs.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace grlib {
+
+struct betweenness_context {
+        betweenness_context() = delete;
+
+        /**
+         * Initialize context
+         * @param graph: csr of the graph, unweighted
+         * @param samples: number of sampled sources, 0 runs exact algorithm from every vertex
+         * @param seed: seed used for choosing sampled sources
+         * @param threads: number of threads used by the algorithm
+         */
+        betweenness_context(const grlib::csr& graph, size_t samples = 0, unsigned seed = 0,
+                unsigned threads = grlib::default_threads())
+        :graph(&graph),
+         samples(samples),
+         seed(seed),
+         threads(threads),
+         normalized(false),
+         centrality(graph.vertices_number(), 0.0) { }
+
+        const grlib::csr* graph;
+        size_t samples;
+        unsigned seed;
+        unsigned threads;
+        bool normalized; /// divide result by number of vertex pairs
+
+        std::vector<double> centrality; /// result
+};
+
+/**
+ * Per-thread state of Brandes algorithm, reused for every source.
+ */
+struct brandes_workspace {
+        brandes_workspace(size_t vertices)
+        : bfs(vertices), sigma(vertices, 0.0), delta(vertices, 0.0) { }
+
+        grlib::bfs_workspace bfs;
+        std::vector<double> sigma; /// number of shortest paths from the source
+        std::vector<double> delta; /// dependency of the source on the vertex
+};
+
+/**
+ * Accumulate dependencies of a single source into centrality.
+ * Predecessors are not stored: edge v -> w lies on a shortest path
+ * iff dist[w] == dist[v] + 1, which is checked again in the backward pass.
+ * @param graph: graph to be processed
+ * @param s: source vertex
+ * @param ws: workspace of the calling thread
+ * @param centrality: accumulator of the calling thread
+ */
+inline void brandes_source(const grlib::csr& graph, grlib::vertex_id s, brandes_workspace& ws,
+                std::vector<double>& centrality)
+{
+        std::vector<int>& dist = ws.bfs.dist;
+        std::vector<grlib::vertex_id>& order = ws.bfs.queue;
+
+        for (grlib::vertex_id v : order) {
+                ws.sigma[v] = 0.0;
+                ws.delta[v] = 0.0;
+        }
+
+        ws.bfs.reset();
+
+        dist[s] = 0;
+        ws.sigma[s] = 1.0;
+        order.push_back(s);
+
+        for (size_t head = 0; head < order.size(); head++) {
+                grlib::vertex_id v = order[head];
+                int next = dist[v] + 1;
+
+                for (grlib::vertex_id w : graph.neighbors(v)) {
+                        if (dist[w] < 0) {
+                                dist[w] = next;
+                                order.push_back(w);
+                        }
+
+                        if (dist[w] == next)
+                                ws.sigma[w] += ws.sigma[v];
+                }
+        }
+
+        for (size_t i = order.size(); i-- > 1; ) {
+                grlib::vertex_id v = order[i];
+                int next = dist[v] + 1;
+                double sum = 0.0;
+
+                for (grlib::vertex_id w : graph.neighbors(v))
+                        if (dist[w] == next)
+                                sum += (1.0 + ws.delta[w]) / ws.sigma[w];
+
+                ws.delta[v] = ws.sigma[v] * sum;
+                centrality[v] += ws.delta[v];
+        }
+}
+
+/**
+ * Brandes betweenness centrality for unweighted graphs. Sources are taken dynamically
+ * by threads, each thread accumulating into its own array; arrays are summed at the end.
+ * In sampled mode, scores are scaled by V / samples.
+ * @param bc: context that algorithm will process
+ */
+inline void betweenness(betweenness_context& bc)
+{
+        const grlib::csr& graph = *bc.graph;
+        size_t n = graph.vertices_number();
+
+        std::vector<grlib::vertex_id> sources(n);
+        std::iota(sources.begin(), sources.end(), 0);
+
+        double scale = 1.0;
+
+        if (bc.samples > 0 and bc.samples < n) {
+                std::mt19937 gen(bc.seed);
+
+                // partial Fisher-Yates shuffle
+                for (size_t i = 0; i < bc.samples; i++) {
+                        std::uniform_int_distribution<size_t> dis(i, n - 1);
+                        std::swap(sources[i], sources[dis(gen)]);
+                }
+
+                sources.resize(bc.samples);
+                scale = static_cast<double>(n) / bc.samples;
+        }
+
+        auto bounds = grlib::partition_evenly(sources.size(), bc.threads);
+        unsigned parts = bounds.size() - 1;
+
+        std::vector<std::vector<double>> local(parts);
+        std::atomic<size_t> next_source(0);
+        constexpr size_t chunk = 16;
+
+        grlib::parallel_for(bounds, [&] (unsigned part, [[maybe_unused]] grlib::vertex_id begin,
+                                [[maybe_unused]] grlib::vertex_id end) {
+                brandes_workspace ws(n);
+                local[part].assign(n, 0.0);
+
+                while (true) {
+                        size_t first = next_source.fetch_add(chunk);
+                        if (first >= sources.size())
+                                break;
+
+                        size_t last = std::min(first + chunk, sources.size());
+                        for (size_t i = first; i < last; i++)
+                                grlib::brandes_source(graph, sources[i], ws, local[part]);
+                }
+        });
+
+        // every pair is counted from both ends in undirected graphs
+        if (!graph.directed)
+                scale /= 2.0;
+
+        if (bc.normalized and n > 2)
+                scale /= graph.directed ? (n - 1.0) * (n - 2.0) : (n - 1.0) * (n - 2.0) / 2.0;
+
+        grlib::parallel_for(grlib::partition_evenly(n, bc.threads), [&] (
+                                [[maybe_unused]] unsigned part, grlib::vertex_id begin,
+                                grlib::vertex_id end) {
+                for (grlib::vertex_id v = begin; v < end; v++) {
+                        double sum = 0.0;
+                        for (unsigned i = 0; i < parts; i++)
+                                sum += local[i][v];
+
+                        bc.centrality[v] = sum * scale;
+                }
+        });
+}
+
+}; // namespace grlib
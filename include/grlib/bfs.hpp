@@ -3,16 +3,17 @@
 
 #include "grlib/adj_list.hpp"
 #include "grlib/adj_matrix.hpp"
+#include "grlib/csr.hpp"
 
 #include <queue>
 #include <functional>
 
 namespace grlib {
 
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>>
 struct bfs_context {
-        using vertex_callback = std::function<void(int, bfs_context<T>&)>;
-        using edge_callback = std::function<void(int, int, bfs_context<T>&)>;
+        using vertex_callback = std::function<void(int, bfs_context<T, Alloc>&)>;
+        using edge_callback = std::function<void(int, int, bfs_context<T, Alloc>&)>;
         bfs_context() = delete;
 
         /**
@@ -23,7 +24,7 @@ struct bfs_context {
          * @param process_edge: callback invoked when edge is processed
          * @param process_vertex_late: callback invoked when node is lately processed
          */
-        bfs_context(grlib::adj_list<T>& alist, int start,
+        bfs_context(grlib::adj_list<T, Alloc>& alist, int start,
                 vertex_callback&& process_vertex_early,
                 edge_callback&& process_edge,
                 vertex_callback&& process_vertex_late)
@@ -35,7 +36,7 @@ struct bfs_context {
          process_vertex_late(process_vertex_late),
          vs(alist.vertices_capacity(), bfs_vertex_state()) { }
 
-        grlib::adj_list<T>* alist;
+        grlib::adj_list<T, Alloc>* alist;
         int start; /// starting vertex index
         int time; /// used for timing
 
@@ -65,10 +66,10 @@ struct bfs_context {
  * Breadth first search implementation based on Steven S. Skiena "The algorithm design manual".
  * @param bfs_context: context that algorithm will process
  */
-template<typename T>
-void bfs(bfs_context<T>& bfs)
+template<typename T, typename Alloc>
+void bfs(bfs_context<T, Alloc>& bfs)
 {
-        grlib::adj_list<T>& alist = *bfs.alist;
+        grlib::adj_list<T, Alloc>& alist = *bfs.alist;
 
         std::queue<int> q;
         int x;
@@ -105,5 +106,64 @@ void bfs(bfs_context<T>& bfs)
         }
 }
 
+/**
+ * Reusable state of breadth-first search. Only vertices touched by the previous search
+ * are reset, so repeated searches cost O(visited) instead of O(V).
+ */
+struct bfs_workspace {
+        bfs_workspace() = default;
+
+        /**
+         * Initialize workspace
+         * @param vertices: number of vertices of searched graphs
+         */
+        bfs_workspace(size_t vertices)
+        : dist(vertices, -1)
+        {
+                queue.reserve(vertices);
+        }
+
+        /**
+         * Forget previous search
+         */
+        void reset()
+        {
+                for (grlib::vertex_id v : queue)
+                        dist[v] = -1;
+
+                queue.clear();
+        }
+
+        std::vector<int> dist; /// distance from the start, -1 if not reached
+        std::vector<grlib::vertex_id> queue; /// visited vertices in order of discovery
+};
+
+/**
+ * Breadth-first search computing distances only, without callbacks.
+ * Graph must provide vertices_number() and neighbors(v), see grlib::csr.
+ * @param graph: graph to be searched
+ * @param start: index of starting vertex
+ * @param ws: workspace, reset before the search
+ */
+template<typename Graph>
+void bfs_levels(const Graph& graph, grlib::vertex_id start, bfs_workspace& ws)
+{
+        ws.reset();
+
+        ws.dist[start] = 0;
+        ws.queue.push_back(start);
+
+        for (size_t head = 0; head < ws.queue.size(); head++) {
+                grlib::vertex_id x = ws.queue[head];
+                int next = ws.dist[x] + 1;
+
+                for (grlib::vertex_id y : graph.neighbors(x))
+                        if (ws.dist[y] < 0) {
+                                ws.dist[y] = next;
+                                ws.queue.push_back(y);
+                        }
+        }
+}
+
 }; // namespace grlib
 
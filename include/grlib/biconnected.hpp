@@ -0,0 +1,148 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/grlib.hpp"
+#include "grlib/parallel.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+struct biconnected_context {
+        biconnected_context() = delete;
+
+        /**
+         * Initialize context. Graph is treated as undirected, multiple edges and
+         * self-loops are ignored.
+         * @param graph: csr of the graph
+         * @param threads: number of threads used to symmetrize the graph
+         */
+        biconnected_context(const grlib::csr& graph, unsigned threads = grlib::default_threads())
+        :graph(grlib::symmetrize(graph, threads)),
+         components_number(0),
+         component(this->graph.edges_number(), -1),
+         articulation(graph.vertices_number(), 0) { }
+
+        grlib::csr graph; /// undirected graph with sorted, unique neighbors
+
+        int components_number;
+        std::vector<int> component; /// biconnected component of each arc of graph, both arcs of an edge share it
+        std::vector<char> articulation; /// whether removing the vertex disconnects its component
+        std::vector<std::pair<grlib::vertex_id, grlib::vertex_id>> bridges; /// edges whose removal disconnects graph
+};
+
+/**
+ * Index of y -> x arc in a csr with sorted neighbors.
+ * @param graph: csr with sorted neighbors
+ * @param y: source of the arc
+ * @param x: target of the arc
+ * @return position of the arc in graph.targets
+ */
+inline size_t twin_arc(const grlib::csr& graph, grlib::vertex_id y, grlib::vertex_id x)
+{
+        auto range = graph.neighbors(y);
+        return std::lower_bound(range.begin(), range.end(), x) - graph.targets.data();
+}
+
+/**
+ * Hopcroft-Tarjan biconnected components with an explicit call stack, so graph depth is
+ * limited by memory only. Edges are pushed on an edge stack when first seen; when
+ * a tree edge (v, w) returns with low[w] >= disc[v], edges above it form a component.
+ * @param bc: context that algorithm will process
+ */
+inline void biconnected_components(biconnected_context& bc)
+{
+        const grlib::csr& graph = bc.graph;
+        size_t n = graph.vertices_number();
+
+        std::vector<int> disc(n, -1);
+        std::vector<int> low(n);
+        std::vector<grlib::vertex_id> parent(n, -1);
+        std::vector<size_t> edges;
+
+        struct frame {
+                grlib::vertex_id v;
+                size_t next; /// next arc to be explored
+                size_t tree_arc; /// arc parent -> v
+        };
+
+        std::vector<frame> calls;
+        int counter = 0;
+
+        std::fill(bc.component.begin(), bc.component.end(), -1);
+        std::fill(bc.articulation.begin(), bc.articulation.end(), 0);
+        bc.bridges.clear();
+        bc.components_number = 0;
+
+        for (size_t root = 0; root < n; root++) {
+                if (disc[root] >= 0)
+                        continue;
+
+                int root_children = 0;
+                disc[root] = low[root] = counter++;
+                calls.push_back({static_cast<grlib::vertex_id>(root), graph.offsets[root], 0});
+
+                while (!calls.empty()) {
+                        frame& f = calls.back();
+                        grlib::vertex_id v = f.v;
+
+                        if (f.next < graph.offsets[v + 1]) {
+                                size_t arc = f.next++;
+                                grlib::vertex_id w = graph.targets[arc];
+
+                                if (disc[w] < 0) {
+                                        edges.push_back(arc);
+                                        parent[w] = v;
+                                        disc[w] = low[w] = counter++;
+                                        root_children += v == static_cast<grlib::vertex_id>(root);
+                                        calls.push_back({w, graph.offsets[w], arc});
+                                } else if (w != parent[v] and disc[w] < disc[v]) {
+                                        edges.push_back(arc);
+                                        low[v] = std::min(low[v], disc[w]);
+                                }
+
+                                continue;
+                        }
+
+                        size_t tree_arc = f.tree_arc;
+                        calls.pop_back();
+
+                        if (calls.empty())
+                                break;
+
+                        grlib::vertex_id u = calls.back().v;
+                        low[u] = std::min(low[u], low[v]);
+
+                        if (low[v] > disc[u])
+                                bc.bridges.emplace_back(u, v);
+
+                        if (low[v] >= disc[u]) {
+                                if (u != static_cast<grlib::vertex_id>(root))
+                                        bc.articulation[u] = 1;
+
+                                size_t arc;
+                                do {
+                                        arc = edges.back();
+                                        edges.pop_back();
+                                        bc.component[arc] = bc.components_number;
+                                } while (arc != tree_arc);
+
+                                bc.components_number++;
+                        }
+                }
+
+                if (root_children > 1)
+                        bc.articulation[root] = 1;
+        }
+
+        // every edge was pushed from one end only
+        for (size_t x = 0; x < n; x++)
+                for (size_t i = graph.offsets[x]; i < graph.offsets[x + 1]; i++)
+                        if (bc.component[i] >= 0)
+                                bc.component[grlib::twin_arc(graph, graph.targets[i], x)] = bc.component[i];
+}
+
+}; // namespace grlib
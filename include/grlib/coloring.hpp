@@ -0,0 +1,145 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace grlib {
+
+struct coloring_context {
+        coloring_context() = delete;
+
+        /**
+         * Initialize context. Graph is treated as undirected, multiple edges and
+         * self-loops are ignored.
+         * @param graph: csr of the graph
+         * @param seed: seed of random tie-breaking between vertices of equal degree
+         * @param threads: number of threads used by the algorithm
+         */
+        coloring_context(const grlib::csr& graph, unsigned seed = 0,
+                unsigned threads = grlib::default_threads())
+        :graph(grlib::symmetrize(graph, threads)),
+         seed(seed),
+         threads(threads),
+         colors_number(0),
+         color(graph.vertices_number(), -1) { }
+
+        grlib::csr graph; /// undirected graph with sorted, unique neighbors
+        unsigned seed;
+        unsigned threads;
+
+        int colors_number; /// number of colors used
+        std::vector<int> color; /// color of each vertex, from 0 to colors_number - 1
+};
+
+/**
+ * Jones-Plassmann parallel greedy coloring with largest-degree-first priorities, ties
+ * broken randomly. A vertex is colored with the smallest color free among its neighbors
+ * once all neighbors of higher priority are colored, so each round colors an independent
+ * set without conflicts. Result equals sequential greedy coloring in priority order and
+ * uses at most max degree + 1 colors.
+ * @param cc: context that algorithm will process
+ */
+inline void coloring(coloring_context& cc)
+{
+        const grlib::csr& graph = cc.graph;
+        size_t n = graph.vertices_number();
+
+        std::vector<std::uint64_t> priority(n);
+        std::mt19937 gen(cc.seed);
+
+        for (size_t v = 0; v < n; v++)
+                priority[v] = (static_cast<std::uint64_t>(graph.degree(v)) << 32) | gen();
+
+        auto before = [&priority] (grlib::vertex_id a, grlib::vertex_id b) {
+                return priority[a] > priority[b] or (priority[a] == priority[b] and a < b);
+        };
+
+        std::vector<std::atomic<int>> waiting(n);
+        auto vertex_bounds = grlib::partition_by_edges(graph.offsets, cc.threads);
+        unsigned parts = vertex_bounds.size() - 1;
+
+        std::vector<std::vector<grlib::vertex_id>> local(parts);
+        std::vector<int> local_max(parts, -1);
+        std::vector<grlib::vertex_id> frontier;
+
+        auto gather = [&] () {
+                frontier.clear();
+                for (auto& l : local) {
+                        frontier.insert(frontier.end(), l.begin(), l.end());
+                        l.clear();
+                }
+        };
+
+        std::fill(cc.color.begin(), cc.color.end(), -1);
+
+        grlib::parallel_for(vertex_bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                grlib::vertex_id end) {
+                for (grlib::vertex_id v = begin; v < end; v++) {
+                        int count = 0;
+
+                        for (grlib::vertex_id u : graph.neighbors(v))
+                                count += before(u, v);
+
+                        waiting[v].store(count, std::memory_order_relaxed);
+
+                        if (count == 0)
+                                local[part].push_back(v);
+                }
+        });
+
+        gather();
+
+        while (!frontier.empty()) {
+                auto bounds = grlib::partition_evenly(frontier.size(), cc.threads);
+
+                grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        std::vector<char> used;
+
+                        for (grlib::vertex_id i = begin; i < end; i++) {
+                                grlib::vertex_id v = frontier[i];
+                                size_t degree = graph.degree(v);
+
+                                // colored neighbors are exactly the ones of higher priority
+                                used.assign(degree + 1, 0);
+                                for (grlib::vertex_id u : graph.neighbors(v)) {
+                                        int c = cc.color[u];
+                                        if (c >= 0 and static_cast<size_t>(c) <= degree)
+                                                used[c] = 1;
+                                }
+
+                                int c = std::find(used.begin(), used.end(), 0) - used.begin();
+                                cc.color[v] = c;
+                                local_max[part] = std::max(local_max[part], c);
+                        }
+                });
+
+                // separate pass: a neighbor must not be released before v has its color
+                grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        for (grlib::vertex_id i = begin; i < end; i++) {
+                                grlib::vertex_id v = frontier[i];
+
+                                for (grlib::vertex_id u : graph.neighbors(v))
+                                        if (before(v, u) and
+                                                        waiting[u].fetch_sub(1, std::memory_order_relaxed) == 1)
+                                                local[part].push_back(u);
+                        }
+                });
+
+                gather();
+        }
+
+        cc.colors_number = 0;
+        for (int m : local_max)
+                cc.colors_number = std::max(cc.colors_number, m + 1);
+}
+
+}; // namespace grlib
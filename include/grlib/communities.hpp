@@ -0,0 +1,154 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace grlib {
+
+struct communities_context {
+        communities_context() = delete;
+
+        /**
+         * Initialize context. Graph is treated as undirected, multiple edges and
+         * self-loops are ignored.
+         * @param graph: csr of the graph
+         * @param seed: seed of vertex order and tie-breaking
+         * @param max_iterations: upper limit of sweeps over all vertices
+         * @param threads: number of threads used by the algorithm
+         */
+        communities_context(const grlib::csr& graph, unsigned seed = 0, int max_iterations = 20,
+                unsigned threads = grlib::default_threads())
+        :graph(grlib::symmetrize(graph, threads)),
+         seed(seed),
+         max_iterations(max_iterations),
+         threads(threads),
+         iterations(0),
+         communities_number(0),
+         community(graph.vertices_number(), -1) { }
+
+        grlib::csr graph; /// undirected graph with sorted, unique neighbors
+        unsigned seed;
+        int max_iterations;
+        unsigned threads;
+
+        int iterations; /// number of sweeps done
+        int communities_number;
+        std::vector<int> community; /// community of each vertex numbered from 1, -1 for isolated vertices (as sccs_context::scc)
+};
+
+/**
+ * Label propagation community detection. Every vertex repeatedly adopts the label most
+ * frequent among its neighbors, keeping its own label when it is one of the most
+ * frequent; other ties are broken by hash_random(). Updates are asynchronous: threads
+ * sweep their ranges of a shuffled vertex order and write labels in place, so later
+ * vertices already see new labels of earlier ones. Stops when a sweep changes nothing.
+ * @param cc: context that algorithm will process
+ */
+inline void label_propagation(communities_context& cc)
+{
+        const grlib::csr& graph = cc.graph;
+        size_t n = graph.vertices_number();
+
+        std::vector<std::atomic<grlib::vertex_id>> label(n);
+        for (size_t v = 0; v < n; v++)
+                label[v].store(v, std::memory_order_relaxed);
+
+        std::vector<grlib::vertex_id> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(cc.seed));
+
+        // equal amount of edges for every thread
+        std::vector<size_t> order_offsets(n + 1, 0);
+        for (size_t i = 0; i < n; i++)
+                order_offsets[i + 1] = order_offsets[i] + graph.degree(order[i]);
+
+        auto bounds = grlib::partition_by_edges(order_offsets, cc.threads);
+        std::vector<size_t> changes(bounds.size() - 1);
+
+        for (cc.iterations = 0; cc.iterations < cc.max_iterations; ) {
+                int iteration = cc.iterations++;
+
+                grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        // neighbors are few, counting in a small vector beats hashing
+                        std::vector<std::pair<grlib::vertex_id, int>> counts;
+                        size_t changed = 0;
+
+                        for (grlib::vertex_id i = begin; i < end; i++) {
+                                grlib::vertex_id v = order[i];
+
+                                if (graph.degree(v) == 0)
+                                        continue;
+
+                                counts.clear();
+                                for (grlib::vertex_id u : graph.neighbors(v))
+                                        counts.emplace_back(label[u].load(std::memory_order_relaxed), 1);
+
+                                std::sort(counts.begin(), counts.end());
+
+                                size_t k = 0;
+                                for (size_t j = 1; j < counts.size(); j++) {
+                                        if (counts[j].first == counts[k].first)
+                                                counts[k].second++;
+                                        else
+                                                counts[++k] = counts[j];
+                                }
+                                counts.resize(k + 1);
+
+                                grlib::vertex_id current = label[v].load(std::memory_order_relaxed);
+                                grlib::vertex_id best = -1;
+                                int best_count = 0;
+                                std::uint64_t best_rank = 0;
+
+                                for (const auto& c : counts) {
+                                        std::uint64_t rank = grlib::hash_random(cc.seed,
+                                                        iteration, (std::uint64_t(v) << 32) ^ c.first);
+
+                                        if (c.second > best_count or (c.second == best_count and
+                                                        best != current and (c.first == current or rank < best_rank))) {
+                                                best = c.first;
+                                                best_count = c.second;
+                                                best_rank = rank;
+                                        }
+                                }
+
+                                if (best != current) {
+                                        label[v].store(best, std::memory_order_relaxed);
+                                        changed++;
+                                }
+                        }
+
+                        changes[part] = changed;
+                });
+
+                if (std::accumulate(changes.begin(), changes.end(), size_t(0)) == 0)
+                        break;
+        }
+
+        // number communities from 1 in order of their first vertex
+        std::vector<int> id(n, 0);
+        cc.communities_number = 0;
+
+        for (size_t v = 0; v < n; v++) {
+                if (graph.degree(v) == 0) {
+                        cc.community[v] = -1;
+                        continue;
+                }
+
+                grlib::vertex_id l = label[v].load(std::memory_order_relaxed);
+                if (id[l] == 0)
+                        id[l] = ++cc.communities_number;
+
+                cc.community[v] = id[l];
+        }
+}
+
+}; // namespace grlib
@@ -0,0 +1,229 @@
+/** @file */
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/grlib.hpp"
+#include "grlib/parallel.hpp"
+
+namespace grlib {
+
+/**
+ * Range of neighbors of a single vertex stored in csr.
+ */
+struct neighbor_range {
+        const grlib::vertex_id* first;
+        const grlib::vertex_id* last;
+
+        const grlib::vertex_id* begin() const { return first; }
+        const grlib::vertex_id* end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+};
+
+/**
+ * Compressed sparse row representation of a graph. Neighbors of vertex v are stored
+ * contiguously in targets[offsets[v]] ... targets[offsets[v + 1] - 1], weights are kept
+ * in parallel array. Structure is immutable view meant for analytics.
+ */
+struct csr {
+        csr()
+        : offsets(1, 0UL), directed(false) { }
+
+        /**
+         * Initialize empty csr
+         * @param vertices: number of vertices
+         * @param directed: whether graph is directed
+         */
+        csr(size_t vertices, bool directed)
+        : offsets(vertices + 1, 0UL), directed(directed) { }
+
+        size_t vertices_number() const
+        {
+                return offsets.size() - 1;
+        }
+
+        size_t edges_number() const
+        {
+                return targets.size();
+        }
+
+        size_t degree(grlib::vertex_id v) const
+        {
+                return offsets[v + 1] - offsets[v];
+        }
+
+        neighbor_range neighbors(grlib::vertex_id v) const
+        {
+                return {targets.data() + offsets[v], targets.data() + offsets[v + 1]};
+        }
+
+        std::vector<size_t> offsets; /// offsets of neighbors of each vertex, size: vertices + 1
+        std::vector<grlib::vertex_id> targets; /// neighbors of all vertices
+        std::vector<int> weights; /// weights of edges, parallel to targets
+        bool directed;
+};
+
+/**
+ * Build csr from adjacency list. Vertices range is adj_list::vertices_number(), so unused
+ * preallocated slots do not become isolated vertices.
+ * @param alist: adjacency list to be converted
+ * @return csr with the same edges order as in the adjacency list
+ */
+template<typename Edge, typename Alloc>
+csr make_csr(const grlib::adj_list<Edge, Alloc>& alist)
+{
+        size_t n = alist.vertices_number();
+        csr graph(n, alist.directed);
+
+        for (size_t v = 0; v < n; v++)
+                graph.offsets[v + 1] = graph.offsets[v] + alist.edges[v].size();
+
+        graph.targets.resize(graph.offsets[n]);
+        graph.weights.resize(graph.offsets[n]);
+
+        for (size_t v = 0; v < n; v++) {
+                size_t pos = graph.offsets[v];
+
+                for (const auto& edge : alist.edges[v]) {
+                        graph.targets[pos] = edge.y;
+                        graph.weights[pos] = edge.weight;
+                        pos++;
+                }
+        }
+
+        return graph;
+}
+
+/**
+ * Build csr with reversed edges: neighbors of v are vertices having an edge to v.
+ * @param graph: csr to be transposed
+ * @return transposed csr, neighbors of each vertex are sorted ascending
+ */
+inline csr transpose(const csr& graph)
+{
+        size_t n = graph.vertices_number();
+        csr t(n, graph.directed);
+
+        for (grlib::vertex_id y : graph.targets)
+                t.offsets[y + 1]++;
+
+        for (size_t v = 0; v < n; v++)
+                t.offsets[v + 1] += t.offsets[v];
+
+        t.targets.resize(graph.edges_number());
+        t.weights.resize(graph.edges_number());
+
+        std::vector<size_t> pos(t.offsets.begin(), t.offsets.end() - 1);
+
+        for (size_t x = 0; x < n; x++)
+                for (size_t i = graph.offsets[x]; i < graph.offsets[x + 1]; i++) {
+                        size_t p = pos[graph.targets[i]]++;
+                        t.targets[p] = x;
+                        t.weights[p] = graph.weights[i];
+                }
+
+        return t;
+}
+
+/**
+ * Sort neighbors of every vertex ascending and remove duplicated edges, keeping weight
+ * of the first one. Vertices are processed in parallel.
+ * @param graph: csr to be processed
+ * @param drop_self_loops: whether x -> x edges should be removed as well
+ * @param threads: number of threads used
+ */
+inline void sort_and_dedupe(csr& graph, bool drop_self_loops = true,
+                unsigned threads = grlib::default_threads())
+{
+        size_t n = graph.vertices_number();
+        std::vector<size_t> degree(n);
+
+        // sort and compact each neighbor list in place
+        grlib::parallel_for(grlib::partition_by_edges(graph.offsets, threads),
+                [&] ([[maybe_unused]] unsigned part, grlib::vertex_id begin, grlib::vertex_id end) {
+                std::vector<std::pair<grlib::vertex_id, int>> list;
+
+                for (grlib::vertex_id v = begin; v < end; v++) {
+                        size_t first = graph.offsets[v], last = graph.offsets[v + 1];
+
+                        list.clear();
+                        for (size_t i = first; i < last; i++)
+                                if (!drop_self_loops or graph.targets[i] != v)
+                                        list.emplace_back(graph.targets[i], graph.weights[i]);
+
+                        std::stable_sort(list.begin(), list.end(),
+                                [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+                        size_t pos = first;
+                        for (size_t i = 0; i < list.size(); i++) {
+                                if (i > 0 and list[i].first == list[i - 1].first)
+                                        continue;
+
+                                graph.targets[pos] = list[i].first;
+                                graph.weights[pos] = list[i].second;
+                                pos++;
+                        }
+
+                        degree[v] = pos - first;
+                }
+        });
+
+        // close the gaps left by removed edges
+        size_t pos = 0;
+        for (size_t v = 0; v < n; v++) {
+                size_t first = graph.offsets[v];
+
+                for (size_t i = 0; i < degree[v]; i++, pos++) {
+                        graph.targets[pos] = graph.targets[first + i];
+                        graph.weights[pos] = graph.weights[first + i];
+                }
+
+                graph.offsets[v] = pos - degree[v];
+        }
+
+        graph.offsets[n] = pos;
+        graph.targets.resize(pos);
+        graph.weights.resize(pos);
+}
+
+/**
+ * Build undirected version of the graph: every x -> y edge is accompanied by y -> x one.
+ * Result has sorted, unique neighbors and no self-loops.
+ * @param graph: csr to be processed
+ * @param threads: number of threads used
+ */
+inline csr symmetrize(const csr& graph, unsigned threads = grlib::default_threads())
+{
+        csr t = grlib::transpose(graph);
+        size_t n = graph.vertices_number();
+        csr sym(n, false);
+
+        for (size_t v = 0; v < n; v++)
+                sym.offsets[v + 1] = sym.offsets[v] + graph.degree(v) + t.degree(v);
+
+        sym.targets.resize(sym.offsets[n]);
+        sym.weights.resize(sym.offsets[n]);
+
+        for (size_t v = 0; v < n; v++) {
+                size_t pos = sym.offsets[v];
+
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++, pos++) {
+                        sym.targets[pos] = graph.targets[i];
+                        sym.weights[pos] = graph.weights[i];
+                }
+
+                for (size_t i = t.offsets[v]; i < t.offsets[v + 1]; i++, pos++) {
+                        sym.targets[pos] = t.targets[i];
+                        sym.weights[pos] = t.weights[i];
+                }
+        }
+
+        grlib::sort_and_dedupe(sym, true, threads);
+        return sym;
+}
+
+}; // namespace grlib
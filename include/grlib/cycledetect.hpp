@@ -15,24 +15,24 @@ namespace grlib {
  * @param cycle_found: callback called when cycle is detected
  * @return throws exception when cycle is found
  */
-template<typename T>
-void cycles_detection(grlib::adj_list<T>& alist, int start,
-                std::function<void(int, int, grlib::dfs_context<T>&)>& cycle_found)
+template<typename T, typename Alloc>
+void cycles_detection(grlib::adj_list<T, Alloc>& alist, int start,
+                std::function<void(int, int, grlib::dfs_context<T, Alloc>&)>& cycle_found)
 {
         auto process_vertex_early = [] ([[maybe_unused]]int v,
-                        [[maybe_unused]]grlib::dfs_context<T>&) {
+                        [[maybe_unused]]grlib::dfs_context<T, Alloc>&) {
         };
 
-        auto process_edge = [&] (int x, int y, grlib::dfs_context<T>& dfs) {
+        auto process_edge = [&] (int x, int y, grlib::dfs_context<T, Alloc>& dfs) {
                 if (dfs.discovered(y) and !dfs.processed(y))
                         cycle_found(x, y, dfs);
         };
 
         auto process_vertex_late = [] ([[maybe_unused]] int v,
-                        [[maybe_unused]]grlib::dfs_context<T>&) {
+                        [[maybe_unused]]grlib::dfs_context<T, Alloc>&) {
         };
 
-        grlib::dfs_context<T> dfs_context{alist, start,
+        grlib::dfs_context<T, Alloc> dfs_context{alist, start,
                 process_vertex_early, process_edge, process_vertex_late};
 
         for (size_t i = 0; i < alist.edges.size(); i++)
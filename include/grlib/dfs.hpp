@@ -10,10 +10,10 @@
 
 namespace grlib {
 
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>>
 struct dfs_context {
-        using vertex_callback = std::function<void(int, dfs_context<T>&)>;
-        using edge_callback = std::function<void(int, int, dfs_context<T>&)>;
+        using vertex_callback = std::function<void(int, dfs_context<T, Alloc>&)>;
+        using edge_callback = std::function<void(int, int, dfs_context<T, Alloc>&)>;
 
         dfs_context() = delete;
 
@@ -25,7 +25,7 @@ struct dfs_context {
          * @param process_edge: callback invoked when edge is processed
          * @param process_vertex_late: callback invoked when node is lately processed
          */
-        dfs_context(grlib::adj_list<T>& alist, int start,
+        dfs_context(grlib::adj_list<T, Alloc>& alist, int start,
                 vertex_callback&& process_vertex_early, edge_callback&& process_edge,
                 vertex_callback&& process_vertex_late)
         :alist(&alist),
@@ -37,7 +37,7 @@ struct dfs_context {
          process_vertex_late(process_vertex_late),
          vs(alist.vertices_capacity(), dfs_vertex_state()) { }
 
-        grlib::adj_list<T>* alist;
+        grlib::adj_list<T, Alloc>* alist;
         int start; /// starting vertex index
         bool finished; /// optional flag allowing early exit
         int time; /// used for timing
@@ -64,8 +64,8 @@ struct dfs_context {
         std::vector<dfs_vertex_state> vs; /// vector of state of each vertex
 };
 
-template<typename T>
-void dfs(dfs_context<T>& dfs)
+template<typename T, typename Alloc>
+void dfs(dfs_context<T, Alloc>& dfs)
 {
         dfs_impl(dfs.start, dfs);
 }
@@ -75,10 +75,10 @@ void dfs(dfs_context<T>& dfs)
  * @param x: starting vertex
  * @param dfs_context: context that algorithm will process
  */
-template<typename T>
-void dfs_impl(int x, dfs_context<T>& dfs)
+template<typename T, typename Alloc>
+void dfs_impl(int x, dfs_context<T, Alloc>& dfs)
 {
-        grlib::adj_list<T>& alist = *dfs.alist;
+        grlib::adj_list<T, Alloc>& alist = *dfs.alist;
 
         if (dfs.finished)
                 return;
@@ -0,0 +1,451 @@
+/** @file */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/rep_base.hpp"
+
+namespace grlib {
+
+/**
+ * Range of target vertices of an edge vector, so that graph algorithms written for
+ * csr::neighbors() work on dynamic_graph as well.
+ */
+template<typename Edge>
+struct edge_target_range {
+        struct iterator {
+                const Edge* edge;
+
+                grlib::vertex_id operator*() const { return edge->y; }
+                iterator& operator++() { ++edge; return *this; }
+                bool operator!=(const iterator& other) const { return edge != other.edge; }
+                bool operator==(const iterator& other) const { return edge == other.edge; }
+        };
+
+        const Edge* first;
+        const Edge* last;
+
+        iterator begin() const { return {first}; }
+        iterator end() const { return {last}; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+};
+
+/**
+ * Adjacency structure for graphs that change all the time. Edges of a vertex are kept in
+ * a vector and removed by swapping with the last one; a hash from (x, y) to positions of
+ * the edge makes insert, remove and lookup O(1) amortized. Directed graphs also keep
+ * incoming edges, so a vertex can be removed without scanning the whole graph.
+ * Removed vertices are tombstoned and their ids stay valid until compact().
+ * Undirected edges are stored as two arcs and enumber counts arcs, as in adj_list.
+ */
+template<typename Edge = grlib::Basic_edge>
+struct dynamic_graph : public Representation_base {
+        /**
+         * Define graph attribute
+         * @param size: number of vertices, all alive
+         * @param directed: whether graph is directed
+         */
+        dynamic_graph(size_t size = 0, bool directed = false);
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        /**
+         * Initialize dynamic graph using graph structure
+         * @param cgraph: Graphviz graph
+         */
+        dynamic_graph(gviz::cgraph& cgraph);
+#endif
+
+        /**
+         * Add new vertex
+         * @param name: name of the vertex in vmap, not registered when empty
+         * @return index of the vertex
+         */
+        grlib::vertex_id add_vertex(const std::string& name = "");
+
+        /**
+         * Tombstone the vertex and remove all its edges
+         * @param v: index of the vertex
+         */
+        void remove_vertex(grlib::vertex_id v);
+
+        /**
+         * Insert x -> y edge (and y -> x one in undirected graph). Weight of an existing
+         * edge is replaced.
+         * @param x: index of first vertex
+         * @param edge: weight structure of the graph
+         * @return false when the edge already existed
+         */
+        bool insert_edge(grlib::vertex_id x, const Edge& edge);
+
+        /**
+         * Remove x -> y edge (and y -> x one in undirected graph)
+         * @param x: index of first vertex
+         * @param y: index of second vertex
+         * @return false when there was no such edge
+         */
+        bool remove_edge(grlib::vertex_id x, grlib::vertex_id y);
+
+        /**
+         * @return edge x -> y, nullptr when it does not exist
+         */
+        const Edge* find_edge(grlib::vertex_id x, grlib::vertex_id y) const;
+
+        bool alive(grlib::vertex_id v) const { return alive_flags[v]; }
+
+        /**
+         * @return range of vertex ids, tombstones included
+         */
+        size_t vertices_number() const { return edges.size(); }
+
+        /**
+         * @return number of vertices that are not removed
+         */
+        size_t alive_number() const { return edges.size() - dead; }
+
+        /**
+         * @return number of tombstones
+         */
+        size_t dead_number() const { return dead; }
+
+        /**
+         * Tombstones slow down traversals and snapshots, compact() when they pile up
+         * @param max_dead_ratio: tolerated share of tombstones among vertex ids
+         * @return whether compact() is recommended
+         */
+        bool needs_compaction(double max_dead_ratio = 0.25) const
+        {
+                return dead > max_dead_ratio * edges.size();
+        }
+
+        edge_target_range<Edge> neighbors(grlib::vertex_id v) const
+        {
+                return {edges[v].data(), edges[v].data() + edges[v].size()};
+        }
+
+        /**
+         * Renumber alive vertices to 0 ... alive_number() - 1 keeping their order, vmap
+         * is updated as well. Invalidates vertex ids held by the caller.
+         * @return new id of each old vertex, -1 for removed ones
+         */
+        std::vector<grlib::vertex_id> compact();
+
+        /**
+         * @return csr snapshot, ids are the same as in the dynamic graph
+         */
+        grlib::csr to_csr() const;
+
+        std::vector<std::vector<Edge>> edges; /// outgoing edges of each vertex, in no particular order
+        std::vector<std::vector<grlib::vertex_id>> sources; /// incoming edges, directed graphs only
+        std::vector<char> alive_flags;
+
+private:
+        struct position {
+                size_t out; /// index in edges[x]
+                size_t in; /// index in sources[y]
+        };
+
+        static std::uint64_t key(grlib::vertex_id x, grlib::vertex_id y)
+        {
+                return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32)
+                        | static_cast<std::uint32_t>(y);
+        }
+
+        bool insert_arc(grlib::vertex_id x, const Edge& edge);
+        bool remove_arc(grlib::vertex_id x, grlib::vertex_id y);
+
+        std::unordered_map<std::uint64_t, position> index;
+        size_t dead;
+};
+
+template<typename Edge>
+dynamic_graph<Edge>::dynamic_graph(size_t size, bool directed)
+: Representation_base(size, directed, 0UL),
+  edges(size),
+  sources(directed ? size : 0),
+  alive_flags(size, 1),
+  dead(0)
+{
+}
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+
+template<typename Edge>
+dynamic_graph<Edge>::dynamic_graph(gviz::cgraph& cgraph)
+: dynamic_graph<Edge>(cgraph.nodes_number(), cgraph.is_directed())
+{
+        for (gviz::Node node : cgraph)
+                vmap.push(node.name(), node.data());
+
+        bool weighted = true;
+        try {
+                cgraph.find_edge_attr("weight");
+        } catch (std::runtime_error& e) {
+                weighted = false;
+        }
+
+        for (gviz::Node node : cgraph)
+                for (gviz::Edge edge : node) {
+                        grlib::vertex_id x = vmap.index(edge.tail().name());
+                        grlib::vertex_id y = vmap.index(edge.head().name());
+                        int weight = weighted ? std::atoi(edge.get_attr("weight").c_str()) : 0;
+
+                        insert_edge(x, Edge(y, weight));
+                }
+}
+
+#endif
+
+template<typename Edge>
+grlib::vertex_id dynamic_graph<Edge>::add_vertex(const std::string& name)
+{
+        grlib::vertex_id v = edges.size();
+
+        edges.emplace_back();
+        alive_flags.push_back(1);
+
+        if (directed)
+                sources.emplace_back();
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        // the slot may be left by a vertex removed before compact()
+        if (static_cast<size_t>(v) < vmap.nodes.size())
+                vmap.nodes[v] = nullptr;
+#endif
+
+        if (!name.empty()) {
+                if (vmap.indexes.count(name))
+                        throw std::runtime_error("add_vertex(): name is already used");
+
+                if (vmap.names.size() <= static_cast<size_t>(v))
+                        vmap.names.resize(std::max<size_t>(2 * vmap.names.size(), v + 1));
+
+                vmap.names[v] = name;
+                vmap.indexes[name] = v;
+                vmap.max_index = std::max<size_t>(vmap.max_index, v + 1);
+        }
+
+        return v;
+}
+
+template<typename Edge>
+void dynamic_graph<Edge>::remove_vertex(grlib::vertex_id v)
+{
+        if (!alive_flags[v])
+                return;
+
+        while (!edges[v].empty())
+                remove_edge(v, edges[v].back().y);
+
+        if (directed)
+                while (!sources[v].empty())
+                        remove_arc(sources[v].back(), v);
+
+        alive_flags[v] = 0;
+        dead++;
+
+        if (static_cast<size_t>(v) < vmap.names.size() and !vmap.names[v].empty()) {
+                vmap.indexes.erase(vmap.names[v]);
+                vmap.names[v].clear();
+        }
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        if (static_cast<size_t>(v) < vmap.nodes.size())
+                vmap.nodes[v] = nullptr;
+#endif
+}
+
+template<typename Edge>
+bool dynamic_graph<Edge>::insert_arc(grlib::vertex_id x, const Edge& edge)
+{
+        auto [it, inserted] = index.try_emplace(key(x, edge.y), position{edges[x].size(), 0});
+
+        if (!inserted) {
+                edges[x][it->second.out] = edge;
+                return false;
+        }
+
+        edges[x].push_back(edge);
+
+        if (directed) {
+                it->second.in = sources[edge.y].size();
+                sources[edge.y].push_back(x);
+        }
+
+        enumber++;
+        return true;
+}
+
+template<typename Edge>
+bool dynamic_graph<Edge>::remove_arc(grlib::vertex_id x, grlib::vertex_id y)
+{
+        auto it = index.find(key(x, y));
+
+        if (it == index.end())
+                return false;
+
+        position pos = it->second;
+        index.erase(it);
+
+        // swap with the last edge of x, which changes its position
+        std::vector<Edge>& out = edges[x];
+        if (pos.out + 1 != out.size()) {
+                out[pos.out] = std::move(out.back());
+                index[key(x, out[pos.out].y)].out = pos.out;
+        }
+        out.pop_back();
+
+        if (directed) {
+                std::vector<grlib::vertex_id>& in = sources[y];
+                if (pos.in + 1 != in.size()) {
+                        in[pos.in] = in.back();
+                        index[key(in[pos.in], y)].in = pos.in;
+                }
+                in.pop_back();
+        }
+
+        enumber--;
+        return true;
+}
+
+template<typename Edge>
+bool dynamic_graph<Edge>::insert_edge(grlib::vertex_id x, const Edge& edge)
+{
+        if (!alive_flags[x] or !alive_flags[edge.y])
+                throw std::runtime_error("insert_edge(): vertex was removed");
+
+        bool inserted = insert_arc(x, edge);
+
+        if (!directed and x != edge.y) {
+                Edge back = edge;
+                back.y = x;
+                insert_arc(edge.y, back);
+        }
+
+        return inserted;
+}
+
+template<typename Edge>
+bool dynamic_graph<Edge>::remove_edge(grlib::vertex_id x, grlib::vertex_id y)
+{
+        bool removed = remove_arc(x, y);
+
+        if (!directed and x != y)
+                remove_arc(y, x);
+
+        return removed;
+}
+
+template<typename Edge>
+const Edge* dynamic_graph<Edge>::find_edge(grlib::vertex_id x, grlib::vertex_id y) const
+{
+        auto it = index.find(key(x, y));
+        return it == index.end() ? nullptr : &edges[x][it->second.out];
+}
+
+template<typename Edge>
+std::vector<grlib::vertex_id> dynamic_graph<Edge>::compact()
+{
+        size_t n = edges.size();
+        std::vector<grlib::vertex_id> remap(n, -1);
+        size_t alive = 0;
+
+        for (size_t v = 0; v < n; v++)
+                if (alive_flags[v])
+                        remap[v] = alive++;
+
+        std::vector<std::vector<Edge>> new_edges(alive);
+        index.clear();
+        index.reserve(enumber);
+
+        for (size_t v = 0; v < n; v++) {
+                if (remap[v] < 0)
+                        continue;
+
+                for (auto& edge : edges[v])
+                        edge.y = remap[edge.y];
+
+                new_edges[remap[v]] = std::move(edges[v]);
+        }
+
+        edges = std::move(new_edges);
+        alive_flags.assign(alive, 1);
+        dead = 0;
+
+        if (directed)
+                sources.assign(alive, {});
+
+        for (size_t x = 0; x < alive; x++)
+                for (size_t i = 0; i < edges[x].size(); i++) {
+                        grlib::vertex_id y = edges[x][i].y;
+                        position pos{i, 0};
+
+                        if (directed) {
+                                pos.in = sources[y].size();
+                                sources[y].push_back(x);
+                        }
+
+                        index.emplace(key(x, y), pos);
+                }
+
+        // names follow their vertices
+        std::vector<std::string> names(alive);
+        vmap.indexes.clear();
+
+        for (size_t v = 0; v < std::min(n, vmap.names.size()); v++)
+                if (remap[v] >= 0 and !vmap.names[v].empty()) {
+                        names[remap[v]] = std::move(vmap.names[v]);
+                        vmap.indexes[names[remap[v]]] = remap[v];
+                }
+
+        vmap.names = std::move(names);
+        vmap.max_index = alive;
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        std::vector<Agnode_t*> nodes(alive, nullptr);
+
+        for (size_t v = 0; v < std::min(n, vmap.nodes.size()); v++)
+                if (remap[v] >= 0)
+                        nodes[remap[v]] = vmap.nodes[v];
+
+        vmap.nodes = std::move(nodes);
+#endif
+
+        return remap;
+}
+
+template<typename Edge>
+grlib::csr dynamic_graph<Edge>::to_csr() const
+{
+        size_t n = edges.size();
+        grlib::csr graph(n, directed);
+
+        for (size_t v = 0; v < n; v++)
+                graph.offsets[v + 1] = graph.offsets[v] + edges[v].size();
+
+        graph.targets.resize(graph.offsets[n]);
+        graph.weights.resize(graph.offsets[n]);
+
+        for (size_t v = 0; v < n; v++) {
+                size_t pos = graph.offsets[v];
+
+                for (const auto& edge : edges[v]) {
+                        graph.targets[pos] = edge.y;
+                        graph.weights[pos] = edge.weight;
+                        pos++;
+                }
+        }
+
+        return graph;
+}
+
+}; // namespace grlib
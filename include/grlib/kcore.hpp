@@ -0,0 +1,238 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace grlib {
+
+struct kcore_context {
+        kcore_context() = delete;
+
+        /**
+         * Initialize context. Graph is treated as undirected, multiple edges and
+         * self-loops are ignored.
+         * @param graph: csr of the graph
+         * @param k_limit: stop peeling at this core number, -1 computes all of them
+         * @param threads: number of threads used by kcore_parallel()
+         */
+        kcore_context(const grlib::csr& graph, int k_limit = -1,
+                unsigned threads = grlib::default_threads())
+        :graph(grlib::symmetrize(graph, threads)),
+         k_limit(k_limit),
+         threads(threads),
+         max_core(0),
+         core(graph.vertices_number(), 0) { }
+
+        grlib::csr graph; /// undirected graph with sorted, unique neighbors
+        int k_limit; /// vertices with core number >= k_limit get k_limit
+        unsigned threads;
+
+        int max_core; /// highest core number found (at most k_limit)
+        std::vector<int> core; /// core number of each vertex
+};
+
+/**
+ * Batagelj-Zaversnik O(V + E) core decomposition. Vertices are kept in an array sorted
+ * by current degree with bucket boundaries, so removing a vertex and decrementing
+ * degree of a neighbor are O(1) swaps.
+ * @param kc: context that algorithm will process
+ */
+inline void kcore(kcore_context& kc)
+{
+        const grlib::csr& graph = kc.graph;
+        size_t n = graph.vertices_number();
+
+        if (n == 0)
+                return;
+
+        std::vector<int> deg(n);
+        int md = 0;
+
+        for (size_t v = 0; v < n; v++) {
+                deg[v] = graph.degree(v);
+                md = std::max(md, deg[v]);
+        }
+
+        // bin[d]: position of first vertex with degree d in vert
+        std::vector<size_t> bin(md + 1, 0);
+        for (size_t v = 0; v < n; v++)
+                bin[deg[v]]++;
+
+        size_t start = 0;
+        for (int d = 0; d <= md; d++) {
+                size_t num = bin[d];
+                bin[d] = start;
+                start += num;
+        }
+
+        std::vector<size_t> pos(n);
+        std::vector<grlib::vertex_id> vert(n);
+
+        for (size_t v = 0; v < n; v++) {
+                pos[v] = bin[deg[v]];
+                vert[pos[v]] = v;
+                bin[deg[v]]++;
+        }
+
+        for (int d = md; d > 0; d--)
+                bin[d] = bin[d - 1];
+        bin[0] = 0;
+
+        kc.max_core = 0;
+
+        for (size_t i = 0; i < n; i++) {
+                grlib::vertex_id v = vert[i];
+
+                if (kc.k_limit >= 0 and deg[v] >= kc.k_limit) {
+                        for (size_t j = i; j < n; j++)
+                                kc.core[vert[j]] = kc.k_limit;
+
+                        kc.max_core = kc.k_limit;
+                        return;
+                }
+
+                kc.core[v] = deg[v];
+                kc.max_core = std::max(kc.max_core, deg[v]);
+
+                for (grlib::vertex_id u : graph.neighbors(v)) {
+                        if (deg[u] <= deg[v])
+                                continue;
+
+                        // move u to the front of its bucket, then shrink the bucket
+                        int du = deg[u];
+                        size_t pu = pos[u];
+                        size_t pw = bin[du];
+                        grlib::vertex_id w = vert[pw];
+
+                        if (u != w) {
+                                pos[u] = pw;
+                                vert[pu] = w;
+                                pos[w] = pu;
+                                vert[pw] = u;
+                        }
+
+                        bin[du]++;
+                        deg[u]--;
+                }
+        }
+}
+
+/**
+ * Level-synchronous parallel peeling. For each k, vertices with degree <= k are removed
+ * in rounds; a neighbor joins the next round when its atomically decremented degree
+ * crosses from k + 1 to k.
+ * @param kc: context that algorithm will process
+ */
+inline void kcore_parallel(kcore_context& kc)
+{
+        const grlib::csr& graph = kc.graph;
+        size_t n = graph.vertices_number();
+
+        if (n == 0)
+                return;
+
+        std::vector<std::atomic<int>> deg(n);
+        std::vector<unsigned char> removed(n, 0);
+
+        for (size_t v = 0; v < n; v++)
+                deg[v].store(graph.degree(v), std::memory_order_relaxed);
+
+        auto vertex_bounds = grlib::partition_evenly(n, kc.threads);
+        unsigned parts = vertex_bounds.size() - 1;
+
+        std::vector<std::vector<grlib::vertex_id>> local(parts);
+        std::vector<int> local_min(parts);
+        std::vector<grlib::vertex_id> frontier;
+
+        size_t remaining = n;
+        int k = 0;
+        kc.max_core = 0;
+
+        auto gather = [&] () {
+                frontier.clear();
+                for (auto& l : local) {
+                        frontier.insert(frontier.end(), l.begin(), l.end());
+                        l.clear();
+                }
+        };
+
+        while (remaining > 0) {
+                // vertices left with degree <= k start the level, k jumps to smallest degree
+                grlib::parallel_for(vertex_bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        int low = -1;
+
+                        for (grlib::vertex_id v = begin; v < end; v++) {
+                                if (removed[v])
+                                        continue;
+
+                                int d = deg[v].load(std::memory_order_relaxed);
+                                if (low < 0 or d < low)
+                                        low = d;
+                        }
+
+                        local_min[part] = low;
+                });
+
+                int low = -1;
+                for (int m : local_min)
+                        if (m >= 0 and (low < 0 or m < low))
+                                low = m;
+
+                k = std::max(k, low);
+
+                if (kc.k_limit >= 0 and k >= kc.k_limit) {
+                        for (size_t v = 0; v < n; v++)
+                                if (!removed[v])
+                                        kc.core[v] = kc.k_limit;
+
+                        kc.max_core = kc.k_limit;
+                        return;
+                }
+
+                grlib::parallel_for(vertex_bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        for (grlib::vertex_id v = begin; v < end; v++)
+                                if (!removed[v] and deg[v].load(std::memory_order_relaxed) <= k)
+                                        local[part].push_back(v);
+                });
+
+                gather();
+                kc.max_core = k;
+
+                while (!frontier.empty()) {
+                        for (grlib::vertex_id v : frontier) {
+                                removed[v] = 1;
+                                kc.core[v] = k;
+                        }
+
+                        remaining -= frontier.size();
+
+                        auto bounds = grlib::partition_evenly(frontier.size(), kc.threads);
+
+                        grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                                grlib::vertex_id end) {
+                                for (grlib::vertex_id i = begin; i < end; i++)
+                                        for (grlib::vertex_id u : graph.neighbors(frontier[i])) {
+                                                if (removed[u])
+                                                        continue;
+
+                                                int old = deg[u].fetch_sub(1, std::memory_order_relaxed);
+                                                if (old == k + 1)
+                                                        local[part].push_back(u);
+                                        }
+                        });
+
+                        gather();
+                }
+
+                k++;
+        }
+}
+
+}; // namespace grlib
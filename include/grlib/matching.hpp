@@ -0,0 +1,215 @@
+/** @file */
+#pragma once
+
+#include "grlib/bfs.hpp"
+#include "grlib/csr.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+/**
+ * Split vertices of undirected graph into two sides using breadth-first search.
+ * @param graph: undirected csr
+ * @return side (0 or 1) of each vertex, throws the exception when graph is not bipartite
+ */
+inline std::vector<char> bipartition(const grlib::csr& graph)
+{
+        size_t n = graph.vertices_number();
+        std::vector<char> side(n, 0);
+        grlib::bfs_workspace ws(n);
+        std::vector<char> visited(n, 0);
+
+        for (size_t v = 0; v < n; v++) {
+                if (visited[v])
+                        continue;
+
+                grlib::bfs_levels(graph, v, ws);
+
+                for (grlib::vertex_id x : ws.queue) {
+                        visited[x] = 1;
+                        side[x] = ws.dist[x] % 2;
+                }
+
+                for (grlib::vertex_id x : ws.queue)
+                        for (grlib::vertex_id y : graph.neighbors(x))
+                                if (side[x] == side[y])
+                                        throw std::runtime_error("bipartition(): graph is not bipartite");
+        }
+
+        return side;
+}
+
+struct matching_context {
+        matching_context() = delete;
+
+        /**
+         * Initialize context. Direction of edges is ignored.
+         * @param graph: csr of bipartite graph
+         * @param side: side (0 or 1) of each vertex; computed from graph when empty
+         */
+        matching_context(const grlib::csr& graph, std::vector<char> side = {})
+        :side(std::move(side)),
+         size(0),
+         mate(graph.vertices_number(), -1)
+        {
+                grlib::csr sym = grlib::symmetrize(graph, 1);
+                size_t n = sym.vertices_number();
+
+                if (this->side.empty())
+                        this->side = grlib::bipartition(sym);
+
+                if (this->side.size() != n)
+                        throw std::runtime_error("matching_context(): invalid size of sides");
+
+                // keep only edges leaving left side
+                left = grlib::csr(n, false);
+
+                for (size_t x = 0; x < n; x++) {
+                        size_t count = 0;
+
+                        for (grlib::vertex_id y : sym.neighbors(x)) {
+                                if (this->side[x] == this->side[y])
+                                        throw std::runtime_error("matching_context(): edge inside one side");
+                                count += this->side[x] == 0;
+                        }
+
+                        left.offsets[x + 1] = left.offsets[x] + count;
+                }
+
+                left.targets.reserve(left.offsets[n]);
+
+                for (size_t x = 0; x < n; x++)
+                        if (this->side[x] == 0)
+                                for (grlib::vertex_id y : sym.neighbors(x))
+                                        left.targets.push_back(y);
+
+                left.weights.assign(left.targets.size(), 0);
+        }
+
+        grlib::csr left; /// edges from left side to the right one
+        std::vector<char> side; /// 0 for vertices on the left side, 1 on the right side
+
+        size_t size; /// number of matched pairs
+        std::vector<grlib::vertex_id> mate; /// matched vertex or -1
+};
+
+/**
+ * Hopcroft-Karp maximum cardinality bipartite matching. Each phase layers left vertices
+ * with a multi-source BFS from all free ones, stopping at the first layer which reaches
+ * a free right vertex, then finds vertex-disjoint shortest augmenting paths with an
+ * explicit-stack DFS restricted to the layers, so there are O(sqrt(V)) phases.
+ * @param mc: context that algorithm will process
+ */
+inline void hopcroft_karp(matching_context& mc)
+{
+        const grlib::csr& adj = mc.left;
+        size_t n = adj.vertices_number();
+        std::vector<grlib::vertex_id>& mate = mc.mate;
+
+        std::fill(mate.begin(), mate.end(), -1);
+        mc.size = 0;
+
+        // greedy start halves the work of first phases
+        for (size_t x = 0; x < n; x++)
+                for (grlib::vertex_id y : adj.neighbors(x))
+                        if (mate[y] < 0) {
+                                mate[x] = y;
+                                mate[y] = x;
+                                mc.size++;
+                                break;
+                        }
+
+        grlib::bfs_workspace ws(n);
+        std::vector<int>& dist = ws.dist;
+        std::vector<size_t> current(n);
+        std::vector<grlib::vertex_id> via(n);
+        std::vector<grlib::vertex_id> stack;
+
+        while (true) {
+                ws.reset();
+
+                for (size_t x = 0; x < n; x++)
+                        if (mc.side[x] == 0 and mate[x] < 0) {
+                                dist[x] = 0;
+                                ws.queue.push_back(x);
+                        }
+
+                size_t roots = ws.queue.size();
+                // layer reaching a free right vertex first, shortest paths end there
+                int limit = -1;
+
+                for (size_t head = 0; head < ws.queue.size(); head++) {
+                        grlib::vertex_id x = ws.queue[head];
+
+                        if (limit >= 0 and dist[x] > limit)
+                                break;
+
+                        for (grlib::vertex_id y : adj.neighbors(x)) {
+                                grlib::vertex_id w = mate[y];
+
+                                if (w < 0) {
+                                        if (limit < 0)
+                                                limit = dist[x];
+                                } else if (dist[w] < 0 and limit < 0) {
+                                        dist[w] = dist[x] + 1;
+                                        ws.queue.push_back(w);
+                                }
+                        }
+                }
+
+                if (limit < 0)
+                        break;
+
+                for (grlib::vertex_id x : ws.queue)
+                        current[x] = adj.offsets[x];
+
+                for (size_t i = 0; i < roots; i++) {
+                        grlib::vertex_id root = ws.queue[i];
+
+                        if (dist[root] != 0 or mate[root] >= 0)
+                                continue;
+
+                        stack.assign(1, root);
+
+                        while (!stack.empty()) {
+                                grlib::vertex_id x = stack.back();
+
+                                if (current[x] == adj.offsets[x + 1]) {
+                                        // dead end, never enter x again in this phase
+                                        dist[x] = -2;
+                                        stack.pop_back();
+                                        continue;
+                                }
+
+                                grlib::vertex_id y = adj.targets[current[x]++];
+                                grlib::vertex_id w = mate[y];
+
+                                // augmenting paths of this phase are all of the shortest length
+                                if (w < 0 ? dist[x] != limit : (dist[w] != dist[x] + 1 or dist[w] > limit))
+                                        continue;
+
+                                via[x] = y;
+
+                                if (w >= 0) {
+                                        stack.push_back(w);
+                                        continue;
+                                }
+
+                                // free vertex reached, flip the path
+                                for (grlib::vertex_id u : stack) {
+                                        mate[u] = via[u];
+                                        mate[via[u]] = u;
+                                }
+
+                                mc.size++;
+                                break;
+                        }
+                }
+        }
+}
+
+}; // namespace grlib
@@ -0,0 +1,456 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+/**
+ * Residual graph. Arcs of vertex v are stored contiguously in [offsets[v], offsets[v + 1]),
+ * every arc a has its reverse arc rev[a] stored among arcs of head[a].
+ */
+struct flow_network {
+        flow_network()
+        : offsets(1, 0UL) { }
+
+        size_t vertices_number() const
+        {
+                return offsets.size() - 1;
+        }
+
+        std::vector<size_t> offsets;
+        std::vector<grlib::vertex_id> head; /// head of each arc
+        std::vector<size_t> rev; /// index of the paired reverse arc
+        std::vector<long long> residual; /// residual capacity of each arc
+        std::vector<long long> capacity; /// original capacity, 0 for reverse arcs
+};
+
+/**
+ * Build residual graph using edge weights as capacities. Self-loops are skipped.
+ * @param graph: csr of the graph
+ * @return residual graph with zero flow
+ */
+inline flow_network make_flow_network(const grlib::csr& graph)
+{
+        size_t n = graph.vertices_number();
+        flow_network net;
+        net.offsets.assign(n + 1, 0UL);
+
+        for (size_t x = 0; x < n; x++)
+                for (grlib::vertex_id y : graph.neighbors(x))
+                        if ((size_t)y != x) {
+                                net.offsets[x + 1]++;
+                                net.offsets[y + 1]++;
+                        }
+
+        for (size_t v = 0; v < n; v++)
+                net.offsets[v + 1] += net.offsets[v];
+
+        size_t m = net.offsets[n];
+        net.head.resize(m);
+        net.rev.resize(m);
+        net.residual.resize(m);
+        net.capacity.resize(m);
+
+        std::vector<size_t> pos(net.offsets.begin(), net.offsets.end() - 1);
+
+        for (size_t x = 0; x < n; x++)
+                for (size_t i = graph.offsets[x]; i < graph.offsets[x + 1]; i++) {
+                        grlib::vertex_id y = graph.targets[i];
+
+                        if ((size_t)y == x)
+                                continue;
+
+                        if (graph.weights[i] < 0)
+                                throw std::runtime_error("make_flow_network(): negative capacity");
+
+                        size_t a = pos[x]++, b = pos[y]++;
+
+                        net.head[a] = y;
+                        net.head[b] = x;
+                        net.rev[a] = b;
+                        net.rev[b] = a;
+                        net.residual[a] = net.capacity[a] = graph.weights[i];
+                        net.residual[b] = net.capacity[b] = 0;
+                }
+
+        return net;
+}
+
+struct maxflow_context {
+        maxflow_context() = delete;
+
+        /**
+         * Initialize context
+         * @param graph: csr of the graph, weights are capacities
+         * @param source: index of source vertex
+         * @param sink: index of sink vertex
+         */
+        maxflow_context(const grlib::csr& graph, grlib::vertex_id source, grlib::vertex_id sink)
+        :net(grlib::make_flow_network(graph)),
+         source(source),
+         sink(sink),
+         flow(0),
+         source_side(graph.vertices_number(), 0)
+        {
+                int n = graph.vertices_number();
+
+                if (source < 0 or source >= n or sink < 0 or sink >= n or source == sink)
+                        throw std::runtime_error("maxflow_context(): invalid source or sink");
+        }
+
+        /**
+         * @param a: index of arc in the residual graph
+         * @return flow sent through the arc
+         */
+        long long arc_flow(size_t a) const
+        {
+                return net.capacity[a] - net.residual[a];
+        }
+
+        grlib::flow_network net;
+        grlib::vertex_id source;
+        grlib::vertex_id sink;
+
+        long long flow; /// value of maximum flow
+        std::vector<char> source_side; /// 1 for vertices on source side of minimum cut
+        std::vector<std::pair<grlib::vertex_id, grlib::vertex_id>> cut_edges; /// edges of min cut
+};
+
+/**
+ * State of highest-label push-relabel algorithm.
+ */
+struct push_relabel {
+        push_relabel(grlib::flow_network& net, grlib::vertex_id s, grlib::vertex_id t)
+        :net(net),
+         n(net.vertices_number()),
+         s(s),
+         t(t),
+         returning(false),
+         highest(-1),
+         max_label(0),
+         work(0),
+         height(n, 0),
+         excess(n, 0),
+         current(n),
+         active(n + 1),
+         label_head(n, -1),
+         label_next(n, -1),
+         label_prev(n, -1),
+         label_count(n, 0) { }
+
+        /**
+         * Move flow from the source to the sink (heights < n), then return excess
+         * of vertices cut off from the sink back to the source.
+         * @return value of maximum flow
+         */
+        long long run()
+        {
+                for (size_t a = net.offsets[s]; a < net.offsets[s + 1]; a++) {
+                        excess[s] += net.residual[a];
+                        push(s, a);
+                }
+
+                global_relabel();
+                discharge_all();
+
+                returning = true;
+                label_from_source();
+                discharge_all();
+
+                return excess[t];
+        }
+
+        void discharge_all()
+        {
+                // global relabel frequency from Cherkassky-Goldberg
+                const size_t relabel_period = 6 * n + net.head.size() / 2;
+
+                while (true) {
+                        if (!returning and work > relabel_period)
+                                global_relabel();
+
+                        while (highest >= 0 and active[highest].empty())
+                                highest--;
+
+                        if (highest < 0)
+                                break;
+
+                        grlib::vertex_id v = active[highest].back();
+                        active[highest].pop_back();
+
+                        if (height[v] == highest and excess[v] > 0)
+                                discharge(v);
+                }
+        }
+
+        void discharge(grlib::vertex_id v)
+        {
+                while (excess[v] > 0) {
+                        size_t a = current[v], end = net.offsets[v + 1];
+
+                        for (; a < end; a++)
+                                if (net.residual[a] > 0 and height[v] == height[net.head[a]] + 1) {
+                                        push(v, a);
+                                        if (excess[v] == 0)
+                                                break;
+                                }
+
+                        current[v] = a;
+
+                        if (excess[v] == 0)
+                                return;
+
+                        relabel(v);
+
+                        if (!returning and height[v] >= (int)n)
+                                return;
+                }
+        }
+
+        void push(grlib::vertex_id v, size_t a)
+        {
+                grlib::vertex_id w = net.head[a];
+                long long delta = std::min(excess[v], net.residual[a]);
+
+                net.residual[a] -= delta;
+                net.residual[net.rev[a]] += delta;
+                excess[v] -= delta;
+
+                bool was_active = excess[w] > 0;
+                excess[w] += delta;
+
+                if (!was_active and w != s and w != t)
+                        activate(w);
+        }
+
+        void activate(grlib::vertex_id v)
+        {
+                int h = height[v];
+
+                if (!returning and h >= (int)n)
+                        return;
+
+                if (h >= (int)active.size())
+                        active.resize(h + 1);
+
+                active[h].push_back(v);
+                highest = std::max(highest, h);
+        }
+
+        void relabel(grlib::vertex_id v)
+        {
+                work += 12 + net.offsets[v + 1] - net.offsets[v];
+
+                int old = height[v];
+
+                if (!returning) {
+                        remove_label(v);
+
+                        // nothing is left at old height, vertices above cannot reach the sink
+                        if (label_count[old] == 0) {
+                                gap(old);
+                                height[v] = n;
+                                return;
+                        }
+                }
+
+                int label = returning ? 2 * n : n;
+                size_t best = net.offsets[v];
+
+                for (size_t a = net.offsets[v]; a < net.offsets[v + 1]; a++)
+                        if (net.residual[a] > 0 and height[net.head[a]] + 1 < label) {
+                                label = height[net.head[a]] + 1;
+                                best = a;
+                        }
+
+                height[v] = label;
+                current[v] = best;
+
+                if (!returning and label < (int)n)
+                        add_label(v);
+        }
+
+        void gap(int g)
+        {
+                for (int h = g + 1; h <= max_label; h++) {
+                        for (grlib::vertex_id v = label_head[h]; v >= 0; v = label_next[v])
+                                height[v] = n;
+
+                        label_head[h] = -1;
+                        label_count[h] = 0;
+                }
+
+                max_label = g - 1;
+        }
+
+        void add_label(grlib::vertex_id v)
+        {
+                int h = height[v];
+
+                label_prev[v] = -1;
+                label_next[v] = label_head[h];
+                if (label_head[h] >= 0)
+                        label_prev[label_head[h]] = v;
+
+                label_head[h] = v;
+                label_count[h]++;
+                max_label = std::max(max_label, h);
+        }
+
+        void remove_label(grlib::vertex_id v)
+        {
+                int h = height[v];
+
+                if (label_prev[v] >= 0)
+                        label_next[label_prev[v]] = label_next[v];
+                else
+                        label_head[h] = label_next[v];
+
+                if (label_next[v] >= 0)
+                        label_prev[label_next[v]] = label_prev[v];
+
+                label_count[h]--;
+        }
+
+        /**
+         * Set heights to exact distances to the sink in residual graph (reverse BFS),
+         * vertices that cannot reach the sink get height n.
+         */
+        void global_relabel()
+        {
+                std::fill(height.begin(), height.end(), (int)n);
+                std::fill(label_head.begin(), label_head.end(), -1);
+                std::fill(label_count.begin(), label_count.end(), 0);
+
+                for (auto& bucket : active)
+                        bucket.clear();
+
+                highest = -1;
+                max_label = 0;
+                work = 0;
+
+                bfs_heights(t, n);
+
+                for (size_t v = 0; v < n; v++) {
+                        current[v] = net.offsets[v];
+
+                        if ((grlib::vertex_id)v == s or height[v] >= (int)n)
+                                continue;
+
+                        add_label(v);
+
+                        if (excess[v] > 0 and (grlib::vertex_id)v != t)
+                                activate(v);
+                }
+        }
+
+        /**
+         * Set heights to n + distance to the source, so remaining excess flows back to it.
+         */
+        void label_from_source()
+        {
+                std::fill(height.begin(), height.end(), 2 * (int)n);
+
+                for (auto& bucket : active)
+                        bucket.clear();
+
+                highest = -1;
+
+                bfs_heights(s, 2 * n);
+
+                for (size_t v = 0; v < n; v++) {
+                        current[v] = net.offsets[v];
+
+                        if (height[v] < 2 * (int)n)
+                                height[v] += n;
+
+                        if (excess[v] > 0 and (grlib::vertex_id)v != s and (grlib::vertex_id)v != t)
+                                activate(v);
+                }
+        }
+
+        /**
+         * Breadth-first search over reversed residual arcs. Terminals other than root are
+         * never entered, so they keep heights they had.
+         * @param root: vertex with height 0
+         * @param unreached: height of vertices not visited yet
+         */
+        void bfs_heights(grlib::vertex_id root, int unreached)
+        {
+                std::vector<grlib::vertex_id> queue{root};
+                height[root] = 0;
+
+                for (size_t i = 0; i < queue.size(); i++) {
+                        grlib::vertex_id w = queue[i];
+
+                        for (size_t a = net.offsets[w]; a < net.offsets[w + 1]; a++) {
+                                grlib::vertex_id u = net.head[a];
+
+                                if (net.residual[net.rev[a]] > 0 and height[u] == unreached
+                                                and u != s and u != t) {
+                                        height[u] = height[w] + 1;
+                                        queue.push_back(u);
+                                }
+                        }
+                }
+        }
+
+        grlib::flow_network& net;
+        size_t n;
+        grlib::vertex_id s;
+        grlib::vertex_id t;
+
+        bool returning; /// second phase: excess goes back to the source
+        int highest; /// highest non-empty active bucket
+        int max_label; /// highest non-empty label list
+        size_t work; /// work since last global relabel
+
+        std::vector<int> height;
+        std::vector<long long> excess;
+        std::vector<size_t> current; /// current arc of each vertex
+        std::vector<std::vector<grlib::vertex_id>> active; /// active vertices by height
+        std::vector<grlib::vertex_id> label_head; /// all vertices by height (< n), for gaps
+        std::vector<grlib::vertex_id> label_next;
+        std::vector<grlib::vertex_id> label_prev;
+        std::vector<int> label_count;
+};
+
+/**
+ * Highest-label push-relabel maximum flow with global relabeling and gap heuristics.
+ * Afterwards source_side holds vertices reachable from the source in residual graph,
+ * and cut_edges the saturated edges leaving them.
+ * @param mf: context that algorithm will process
+ */
+inline void max_flow(maxflow_context& mf)
+{
+        grlib::flow_network& net = mf.net;
+        grlib::push_relabel pr(net, mf.source, mf.sink);
+
+        mf.flow = pr.run();
+
+        std::fill(mf.source_side.begin(), mf.source_side.end(), 0);
+        mf.cut_edges.clear();
+
+        std::vector<grlib::vertex_id> queue{mf.source};
+        mf.source_side[mf.source] = 1;
+
+        for (size_t i = 0; i < queue.size(); i++)
+                for (size_t a = net.offsets[queue[i]]; a < net.offsets[queue[i] + 1]; a++)
+                        if (net.residual[a] > 0 and !mf.source_side[net.head[a]]) {
+                                mf.source_side[net.head[a]] = 1;
+                                queue.push_back(net.head[a]);
+                        }
+
+        for (grlib::vertex_id x : queue)
+                for (size_t a = net.offsets[x]; a < net.offsets[x + 1]; a++)
+                        if (net.capacity[a] > 0 and !mf.source_side[net.head[a]])
+                                mf.cut_edges.emplace_back(x, net.head[a]);
+}
+
+}; // namespace grlib
@@ -0,0 +1,277 @@
+/** @file */
+#pragma once
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/parallel.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace grlib {
+
+struct pagerank_context {
+        pagerank_context() = delete;
+
+        /**
+         * Initialize context
+         * @param graph: csr of the graph, edges x -> y
+         * @param damping: probability of following an edge
+         * @param tolerance: algorithm stops when L1 norm of rank change drops below it
+         * @param max_iterations: upper bound of performed iterations
+         * @param threads: number of threads used by the algorithm
+         */
+        pagerank_context(const grlib::csr& graph, double damping = 0.85, double tolerance = 1e-6,
+                int max_iterations = 100, unsigned threads = grlib::default_threads())
+        :out(&graph),
+         in(grlib::transpose(graph)),
+         damping(damping),
+         tolerance(tolerance),
+         threshold(1e-3),
+         max_iterations(max_iterations),
+         threads(threads),
+         iterations(0),
+         residual(0.0),
+         inv_degree(graph.vertices_number(), 0.0),
+         rank(graph.vertices_number(), 0.0)
+        {
+                for (size_t v = 0; v < inv_degree.size(); v++)
+                        if (graph.degree(v))
+                                inv_degree[v] = 1.0 / graph.degree(v);
+        }
+
+        const grlib::csr* out; /// graph with outgoing edges
+        grlib::csr in; /// transposed graph, used for pulling ranks
+
+        double damping;
+        double tolerance;
+        double threshold; /// pagerank_delta(): relative change needed to propagate vertex
+        int max_iterations;
+        unsigned threads;
+
+        int iterations; /// number of performed iterations
+        double residual; /// L1 norm of the last rank change
+
+        std::vector<double> inv_degree; /// 1 / out degree, 0 for dangling vertices
+        std::vector<double> rank; /// result
+};
+
+/**
+ * Sum of values at given indexes. Four independent accumulators break the dependency
+ * chain of additions, so gathered loads can be issued in parallel.
+ */
+inline double gather_sum(const double* values, const grlib::vertex_id* first,
+                const grlib::vertex_id* last)
+{
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+
+        for (; last - first >= 4; first += 4) {
+                s0 += values[first[0]];
+                s1 += values[first[1]];
+                s2 += values[first[2]];
+                s3 += values[first[3]];
+        }
+
+        for (; first != last; ++first)
+                s0 += values[*first];
+
+        return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * Pull-based power iteration. Rank of dangling vertices is spread uniformly.
+ * Vertices are split between threads by number of incoming edges.
+ * @param pr: context that algorithm will process
+ */
+inline void pagerank(pagerank_context& pr)
+{
+        size_t n = pr.in.vertices_number();
+
+        if (n == 0)
+                return;
+
+        const double d = pr.damping;
+        std::vector<double>& rank = pr.rank;
+        std::vector<double> next(n);
+        std::vector<double> contrib(n);
+
+        auto bounds = grlib::partition_by_edges(pr.in.offsets, pr.threads);
+        unsigned parts = bounds.size() - 1;
+
+        std::vector<double> part_dangling(parts);
+        std::vector<double> part_residual(parts);
+
+        double dangling = 0.0;
+
+        std::fill(rank.begin(), rank.end(), 1.0 / n);
+
+        for (size_t v = 0; v < n; v++) {
+                contrib[v] = rank[v] * pr.inv_degree[v];
+                if (pr.inv_degree[v] == 0.0)
+                        dangling += rank[v];
+        }
+
+        for (pr.iterations = 0; pr.iterations < pr.max_iterations; ) {
+                const double base = (1.0 - d) / n + d * dangling / n;
+
+                grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        const double* c = contrib.data();
+                        const size_t* off = pr.in.offsets.data();
+                        const grlib::vertex_id* adj = pr.in.targets.data();
+
+                        for (grlib::vertex_id v = begin; v < end; v++)
+                                next[v] = base + d * gather_sum(c, adj + off[v], adj + off[v + 1]);
+
+                        // contiguous passes over ranges, vectorized by the compiler
+                        double res = 0.0, dang = 0.0;
+                        for (grlib::vertex_id v = begin; v < end; v++)
+                                res += std::fabs(next[v] - rank[v]);
+
+                        for (grlib::vertex_id v = begin; v < end; v++)
+                                dang += pr.inv_degree[v] == 0.0 ? next[v] : 0.0;
+
+                        part_residual[part] = res;
+                        part_dangling[part] = dang;
+                });
+
+                rank.swap(next);
+                pr.iterations++;
+
+                pr.residual = 0.0;
+                dangling = 0.0;
+                for (unsigned i = 0; i < parts; i++) {
+                        pr.residual += part_residual[i];
+                        dangling += part_dangling[i];
+                }
+
+                if (pr.residual < pr.tolerance)
+                        break;
+
+                for (size_t v = 0; v < n; v++)
+                        contrib[v] = rank[v] * pr.inv_degree[v];
+        }
+}
+
+/**
+ * Delta-based PageRank. Every vertex accumulates pending change of its rank and
+ * propagates it to neighbors only when it exceeds pr.threshold * rank, so vertices
+ * that have already converged stop generating work. Only vertices with an incoming
+ * edge from a propagating vertex are recomputed in each iteration.
+ * @param pr: context that algorithm will process
+ */
+inline void pagerank_delta(pagerank_context& pr)
+{
+        size_t n = pr.in.vertices_number();
+
+        if (n == 0)
+                return;
+
+        const double d = pr.damping;
+        std::vector<double>& rank = pr.rank;
+        std::vector<double> pending(n, (1.0 - d) / n);
+        std::vector<double> contrib(n, 0.0);
+        std::vector<std::atomic<unsigned char>> dirty(n);
+
+        auto out_bounds = grlib::partition_by_edges(pr.out->offsets, pr.threads);
+        auto in_bounds = grlib::partition_by_edges(pr.in.offsets, pr.threads);
+
+        std::vector<double> part_dangling(out_bounds.size() - 1);
+        std::vector<double> part_residual(out_bounds.size() - 1);
+        std::vector<size_t> part_active(out_bounds.size() - 1);
+
+        std::fill(rank.begin(), rank.end(), 0.0);
+
+        for (pr.iterations = 0; pr.iterations < pr.max_iterations; pr.iterations++) {
+                // apply significant changes and mark vertices that need to pull them
+                grlib::parallel_for(out_bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                        grlib::vertex_id end) {
+                        double res = 0.0, dang = 0.0;
+                        size_t active = 0;
+
+                        for (grlib::vertex_id v = begin; v < end; v++) {
+                                double delta = pending[v];
+
+                                if (std::fabs(delta) <= pr.threshold * rank[v]) {
+                                        contrib[v] = 0.0;
+                                        continue;
+                                }
+
+                                rank[v] += delta;
+                                pending[v] = 0.0;
+                                res += std::fabs(delta);
+                                active++;
+
+                                if (pr.inv_degree[v] == 0.0) {
+                                        contrib[v] = 0.0;
+                                        dang += delta;
+                                        continue;
+                                }
+
+                                contrib[v] = delta * pr.inv_degree[v];
+
+                                for (grlib::vertex_id y : pr.out->neighbors(v))
+                                        dirty[y].store(1, std::memory_order_relaxed);
+                        }
+
+                        part_residual[part] = res;
+                        part_dangling[part] = dang;
+                        part_active[part] = active;
+                });
+
+                double dangling = 0.0;
+                size_t active = 0;
+                pr.residual = 0.0;
+
+                for (size_t i = 0; i < part_active.size(); i++) {
+                        pr.residual += part_residual[i];
+                        dangling += part_dangling[i];
+                        active += part_active[i];
+                }
+
+                if (active == 0 or pr.residual < pr.tolerance)
+                        break;
+
+                const double spread = d * dangling / n;
+
+                grlib::parallel_for(in_bounds, [&] ([[maybe_unused]] unsigned part,
+                                        grlib::vertex_id begin, grlib::vertex_id end) {
+                        const grlib::vertex_id* adj = pr.in.targets.data();
+                        const size_t* off = pr.in.offsets.data();
+
+                        for (grlib::vertex_id v = begin; v < end; v++) {
+                                if (dirty[v].load(std::memory_order_relaxed)) {
+                                        dirty[v].store(0, std::memory_order_relaxed);
+                                        pending[v] += d * gather_sum(contrib.data(),
+                                                        adj + off[v], adj + off[v + 1]);
+                                }
+
+                                pending[v] += spread;
+                        }
+                });
+        }
+
+        // changes below threshold are still part of the result
+        for (size_t v = 0; v < n; v++)
+                rank[v] += pending[v];
+}
+
+/**
+ * Convenience wrapper computing PageRank of adjacency list.
+ * @param alist: adjacency list to be processed
+ * @param damping: probability of following an edge
+ * @param tolerance: algorithm stops when L1 norm of rank change drops below it
+ * @return rank of each vertex
+ */
+template<typename T, typename Alloc>
+std::vector<double> pagerank(const grlib::adj_list<T, Alloc>& alist, double damping = 0.85,
+                double tolerance = 1e-6)
+{
+        grlib::csr graph = grlib::make_csr(alist);
+        grlib::pagerank_context pr(graph, damping, tolerance);
+        grlib::pagerank(pr);
+        return pr.rank;
+}
+
+}; // namespace grlib
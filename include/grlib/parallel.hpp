@@ -0,0 +1,115 @@
+/** @file */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "grlib/grlib.hpp"
+
+namespace grlib {
+
+/**
+ * @return number of threads used by parallel algorithms when not specified
+ */
+inline unsigned default_threads()
+{
+        unsigned threads = std::thread::hardware_concurrency();
+        return threads ? threads : 1;
+}
+
+/**
+ * Counter-based random number: the same arguments always give the same value, so
+ * threads need no shared generator and results do not depend on scheduling.
+ * @param seed: seed of the sequence
+ * @param a: first counter, e.g. iteration
+ * @param b: second counter, e.g. vertex
+ * @return 64 pseudo-random bits (splitmix64 finalizer)
+ */
+inline std::uint64_t hash_random(std::uint64_t seed, std::uint64_t a, std::uint64_t b)
+{
+        std::uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (a + 1) + 0xBF58476D1CE4E5B9ULL * (b + 1);
+
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+}
+
+/**
+ * Split vertices into contiguous ranges with roughly equal amount of work,
+ * where work of a vertex is its number of edges plus one.
+ * @param offsets: csr offsets (size: vertices + 1)
+ * @param parts: requested number of ranges
+ * @return bounds of ranges, range i is [bounds[i], bounds[i + 1])
+ */
+inline std::vector<grlib::vertex_id> partition_by_edges(const std::vector<size_t>& offsets,
+                unsigned parts)
+{
+        size_t n = offsets.size() - 1;
+        parts = std::max(1U, std::min<unsigned>(parts, std::max<size_t>(n, 1)));
+
+        size_t total = offsets[n] + n;
+        std::vector<grlib::vertex_id> bounds(parts + 1, 0);
+
+        for (unsigned i = 1; i < parts; i++) {
+                size_t goal = total * i / parts;
+
+                // work(v) = offsets[v] + v is monotonic, binary search first vertex reaching goal
+                size_t lo = bounds[i - 1], hi = n;
+                while (lo < hi) {
+                        size_t mid = (lo + hi) / 2;
+                        if (offsets[mid] + mid < goal)
+                                lo = mid + 1;
+                        else
+                                hi = mid;
+                }
+
+                bounds[i] = lo;
+        }
+
+        bounds[parts] = n;
+        return bounds;
+}
+
+/**
+ * Split range [0, n) into parts ranges of equal size.
+ * @param n: size of the range
+ * @param parts: requested number of ranges
+ * @return bounds of ranges, range i is [bounds[i], bounds[i + 1])
+ */
+inline std::vector<grlib::vertex_id> partition_evenly(size_t n, unsigned parts)
+{
+        parts = std::max(1U, std::min<unsigned>(parts, std::max<size_t>(n, 1)));
+
+        std::vector<grlib::vertex_id> bounds(parts + 1);
+
+        for (unsigned i = 0; i <= parts; i++)
+                bounds[i] = n * i / parts;
+
+        return bounds;
+}
+
+/**
+ * Run func(thread_index, begin, end) for each range in its own thread.
+ * Last range is processed by the calling thread.
+ * @param bounds: bounds of ranges, see partition_by_edges()
+ * @param func: callable invoked for each range
+ */
+template<typename Func>
+void parallel_for(const std::vector<grlib::vertex_id>& bounds, Func&& func)
+{
+        unsigned parts = bounds.size() - 1;
+        std::vector<std::thread> workers;
+        workers.reserve(parts - 1);
+
+        for (unsigned i = 0; i + 1 < parts; i++)
+                workers.emplace_back([&func, &bounds, i] { func(i, bounds[i], bounds[i + 1]); });
+
+        func(parts - 1, bounds[parts - 1], bounds[parts]);
+
+        for (auto& worker : workers)
+                worker.join();
+}
+
+}; // namespace grlib
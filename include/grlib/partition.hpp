@@ -0,0 +1,476 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/grlib.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+struct partition_context {
+        partition_context() = delete;
+
+        /**
+         * Initialize context. Graph is treated as undirected, every edge has weight 1,
+         * multiple edges and self-loops are ignored.
+         * @param graph: csr of the graph
+         * @param parts: number of parts
+         * @param imbalance: allowed excess of part size over V / parts, 0.03 is 3%
+         * @param seed: seed of randomized matching
+         */
+        partition_context(const grlib::csr& graph, int parts, double imbalance = 0.03,
+                unsigned seed = 0)
+        :graph(grlib::symmetrize(graph)),
+         parts(parts),
+         imbalance(imbalance),
+         seed(seed),
+         edge_cut(0),
+         part(graph.vertices_number(), 0),
+         part_size(parts > 0 ? parts : 0, 0),
+         cut_edges(parts > 0 ? parts : 0, 0)
+        {
+                if (parts < 1)
+                        throw std::runtime_error("partition_context(): number of parts must be positive");
+        }
+
+        grlib::csr graph; /// undirected graph with sorted, unique neighbors
+        int parts;
+        double imbalance;
+        unsigned seed;
+
+        size_t edge_cut; /// number of edges between different parts
+        std::vector<int> part; /// part of each vertex, from 0 to parts - 1
+        std::vector<size_t> part_size; /// number of vertices in each part
+        std::vector<size_t> cut_edges; /// number of edges leaving each part
+};
+
+/**
+ * One level of the multilevel hierarchy: weighted graph and mapping of its vertices
+ * to the vertices of the next, coarser level.
+ */
+struct partition_level {
+        grlib::csr graph; /// weights are numbers of merged edges
+        std::vector<int> vweight; /// number of merged vertices
+        std::vector<grlib::vertex_id> coarse; /// vertex of the coarser level
+};
+
+/**
+ * Heavy-edge matching: vertices are visited in random order and matched with the
+ * unmatched neighbor connected by the heaviest edge. Matched pairs are contracted.
+ * @param level: level to be coarsened, its coarse mapping is filled
+ * @param max_vweight: matched pair may not be heavier
+ * @param gen: random generator
+ * @return coarser level
+ */
+inline partition_level coarsen(partition_level& level, int max_vweight, std::mt19937& gen)
+{
+        const grlib::csr& graph = level.graph;
+        size_t n = graph.vertices_number();
+
+        std::vector<grlib::vertex_id> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), gen);
+
+        std::vector<grlib::vertex_id> mate(n, -1);
+        level.coarse.assign(n, -1);
+        size_t cn = 0;
+
+        for (grlib::vertex_id v : order) {
+                if (mate[v] >= 0)
+                        continue;
+
+                grlib::vertex_id best = v;
+                int best_weight = 0;
+
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                        grlib::vertex_id u = graph.targets[i];
+
+                        if (mate[u] < 0 and u != v and graph.weights[i] > best_weight and
+                                        level.vweight[u] + level.vweight[v] <= max_vweight) {
+                                best = u;
+                                best_weight = graph.weights[i];
+                        }
+                }
+
+                mate[v] = best;
+                mate[best] = v;
+                level.coarse[v] = level.coarse[best] = cn++;
+        }
+
+        partition_level result;
+        result.vweight.assign(cn, 0);
+        result.graph = grlib::csr(cn, false);
+
+        // constituents of each coarse vertex
+        std::vector<size_t> first(cn + 1, 0);
+        std::vector<grlib::vertex_id> members(n);
+
+        for (size_t v = 0; v < n; v++) {
+                first[level.coarse[v] + 1]++;
+                result.vweight[level.coarse[v]] += level.vweight[v];
+        }
+
+        for (size_t c = 0; c < cn; c++)
+                first[c + 1] += first[c];
+
+        std::vector<size_t> pos(first.begin(), first.end() - 1);
+        for (size_t v = 0; v < n; v++)
+                members[pos[level.coarse[v]]++] = v;
+
+        // sum weights of parallel edges using slot of each target in the current list
+        std::vector<long long> slot(cn, -1);
+
+        for (size_t c = 0; c < cn; c++) {
+                size_t begin = result.graph.targets.size();
+
+                for (size_t m = first[c]; m < first[c + 1]; m++) {
+                        grlib::vertex_id v = members[m];
+
+                        for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                                grlib::vertex_id d = level.coarse[graph.targets[i]];
+
+                                if (static_cast<size_t>(d) == c)
+                                        continue;
+
+                                if (slot[d] < 0) {
+                                        slot[d] = result.graph.targets.size();
+                                        result.graph.targets.push_back(d);
+                                        result.graph.weights.push_back(0);
+                                }
+
+                                result.graph.weights[slot[d]] += graph.weights[i];
+                        }
+                }
+
+                for (size_t i = begin; i < result.graph.targets.size(); i++)
+                        slot[result.graph.targets[i]] = -1;
+
+                result.graph.offsets[c + 1] = result.graph.targets.size();
+        }
+
+        return result;
+}
+
+/**
+ * Initial partition of the coarsest graph: vertices are listed in breadth-first order,
+ * component after component, and the list is cut into parts of equal weight.
+ * @param level: coarsest level
+ * @param parts: number of parts
+ * @param part: result, part of each vertex
+ * @param start: vertex where the first search starts
+ */
+inline void initial_partition(const partition_level& level, int parts, std::vector<int>& part,
+                grlib::vertex_id start = 0)
+{
+        const grlib::csr& graph = level.graph;
+        size_t n = graph.vertices_number();
+
+        std::vector<grlib::vertex_id> order;
+        std::vector<char> visited(n, 0);
+        order.reserve(n);
+
+        for (size_t i = 0; i < n; i++) {
+                grlib::vertex_id root = (start + i) % n;
+
+                if (visited[root])
+                        continue;
+
+                visited[root] = 1;
+                order.push_back(root);
+
+                for (size_t head = order.size() - 1; head < order.size(); head++)
+                        for (grlib::vertex_id u : graph.neighbors(order[head]))
+                                if (!visited[u]) {
+                                        visited[u] = 1;
+                                        order.push_back(u);
+                                }
+        }
+
+        long long total = std::accumulate(level.vweight.begin(), level.vweight.end(), 0LL);
+        long long sum = 0;
+        part.assign(n, 0);
+
+        for (grlib::vertex_id v : order) {
+                // part containing the middle of the vertex weight
+                long long middle = 2 * sum + level.vweight[v];
+                part[v] = std::min<long long>(parts - 1, middle * parts / (2 * std::max(total, 1LL)));
+                sum += level.vweight[v];
+        }
+}
+
+/**
+ * @param level: weighted graph
+ * @param part: part of each vertex
+ * @return total weight of edges between different parts
+ */
+inline long long weighted_cut(const partition_level& level, const std::vector<int>& part)
+{
+        const grlib::csr& graph = level.graph;
+        long long cut = 0;
+
+        for (size_t v = 0; v < graph.vertices_number(); v++)
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++)
+                        if (part[graph.targets[i]] != part[v])
+                                cut += graph.weights[i];
+
+        return cut / 2;
+}
+
+/**
+ * K-way Fiduccia-Mattheyses refinement. Each pass moves unlocked vertices with the best
+ * gain (cut reduction) even if it is negative, locking them, then rolls back to the
+ * prefix of moves with the lowest cut. Parts heavier than max_weight are first relieved
+ * by their cheapest moves.
+ * @param level: level being refined
+ * @param parts: number of parts
+ * @param max_weight: upper bound of part weight
+ * @param part: partition to be refined
+ * @param passes: upper limit of passes
+ */
+inline void fm_refine(const partition_level& level, int parts, long long max_weight,
+                std::vector<int>& part, int passes = 8)
+{
+        const grlib::csr& graph = level.graph;
+        const std::vector<int>& vw = level.vweight;
+        size_t n = graph.vertices_number();
+
+        std::vector<long long> pw(parts, 0);
+        for (size_t v = 0; v < n; v++)
+                pw[part[v]] += vw[v];
+
+        std::vector<long long> conn(parts, 0);
+        std::vector<int> touched;
+
+        // best move of v: gain and target part, target -1 when no move fits
+        auto best_move = [&] (grlib::vertex_id v, bool force) {
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                        int p = part[graph.targets[i]];
+                        if (conn[p] == 0)
+                                touched.push_back(p);
+                        conn[p] += graph.weights[i];
+                }
+
+                int own = part[v];
+                long long gain = std::numeric_limits<long long>::min();
+                int target = -1;
+
+                for (int p : touched)
+                        if (p != own and pw[p] + vw[v] <= max_weight) {
+                                long long g = conn[p] - conn[own];
+
+                                if (target < 0 or g > gain or (g == gain and pw[p] < pw[target])) {
+                                        gain = g;
+                                        target = p;
+                                }
+                        }
+
+                // overweight part may push vertices into any part with room
+                if (force and target < 0)
+                        for (int p = 0; p < parts; p++)
+                                if (p != own and pw[p] + vw[v] <= max_weight and
+                                                (target < 0 or pw[p] < pw[target])) {
+                                        gain = conn[p] - conn[own];
+                                        target = p;
+                                }
+
+                for (int p : touched)
+                        conn[p] = 0;
+                touched.clear();
+
+                return std::make_pair(gain, target);
+        };
+
+        auto move = [&] (grlib::vertex_id v, int to) {
+                pw[part[v]] -= vw[v];
+                pw[to] += vw[v];
+                part[v] = to;
+        };
+
+        // balancing
+        for (int p = 0; p < parts; p++) {
+                if (pw[p] <= max_weight)
+                        continue;
+
+                std::vector<std::tuple<long long, grlib::vertex_id>> candidates;
+                for (size_t v = 0; v < n; v++)
+                        if (part[v] == p)
+                                candidates.emplace_back(best_move(v, true).first, v);
+
+                std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+                for (const auto& c : candidates) {
+                        if (pw[p] <= max_weight)
+                                break;
+
+                        grlib::vertex_id v = std::get<1>(c);
+                        auto m = best_move(v, true);
+
+                        if (m.second >= 0)
+                                move(v, m.second);
+                }
+        }
+
+        std::vector<char> locked(n);
+        std::vector<std::tuple<long long, grlib::vertex_id, int>> heap;
+        std::vector<std::pair<grlib::vertex_id, int>> moves;
+        size_t patience = std::max<size_t>(50, n / 100);
+
+        auto push = [&] (grlib::vertex_id v) {
+                auto m = best_move(v, false);
+                if (m.second >= 0) {
+                        heap.emplace_back(m.first, v, m.second);
+                        std::push_heap(heap.begin(), heap.end());
+                }
+        };
+
+        for (int pass = 0; pass < passes; pass++) {
+                std::fill(locked.begin(), locked.end(), 0);
+                heap.clear();
+                moves.clear();
+
+                for (size_t v = 0; v < n; v++)
+                        for (grlib::vertex_id u : graph.neighbors(v))
+                                if (part[u] != part[v]) {
+                                        push(v);
+                                        break;
+                                }
+
+                long long delta = 0, best_delta = 0;
+                size_t best_length = 0, since_best = 0;
+
+                while (!heap.empty() and since_best < patience) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        auto [gain, v, to] = heap.back();
+                        heap.pop_back();
+
+                        if (locked[v])
+                                continue;
+
+                        auto m = best_move(v, false);
+                        if (m.second < 0)
+                                continue;
+
+                        // outdated entry, queue it again with current gain
+                        if (m.first != gain or m.second != to) {
+                                heap.emplace_back(m.first, v, m.second);
+                                std::push_heap(heap.begin(), heap.end());
+                                continue;
+                        }
+
+                        moves.emplace_back(v, part[v]);
+                        move(v, to);
+                        locked[v] = 1;
+                        delta -= gain;
+
+                        if (delta < best_delta) {
+                                best_delta = delta;
+                                best_length = moves.size();
+                                since_best = 0;
+                        } else {
+                                since_best++;
+                        }
+
+                        for (grlib::vertex_id u : graph.neighbors(v))
+                                if (!locked[u])
+                                        push(u);
+                }
+
+                while (moves.size() > best_length) {
+                        move(moves.back().first, moves.back().second);
+                        moves.pop_back();
+                }
+
+                if (best_length == 0)
+                        break;
+        }
+}
+
+/**
+ * Multilevel k-way partitioning: the graph is coarsened by heavy-edge matching until
+ * it is small, partitioned, then the partition is projected back level by level and
+ * refined by fm_refine() on each of them. Statistics are computed at the end.
+ * @param pc: context that algorithm will process
+ */
+inline void partition(partition_context& pc)
+{
+        size_t n = pc.graph.vertices_number();
+        std::mt19937 gen(pc.seed);
+
+        std::vector<partition_level> levels(1);
+        levels[0].graph = pc.graph;
+        levels[0].vweight.assign(n, 1);
+        std::fill(levels[0].graph.weights.begin(), levels[0].graph.weights.end(), 1);
+
+        long long max_weight = static_cast<long long>(
+                std::ceil((1.0 + pc.imbalance) * n / pc.parts));
+        int max_vweight = std::max<long long>(1, n / (pc.parts * 20));
+        size_t small = std::max(20 * pc.parts, 100);
+
+        while (levels.back().graph.vertices_number() > small) {
+                partition_level next = grlib::coarsen(levels.back(), max_vweight, gen);
+
+                // matching stalls on stars and when vertices reach max_vweight
+                if (next.graph.vertices_number() > 0.95 * levels.back().graph.vertices_number())
+                        break;
+
+                levels.push_back(std::move(next));
+        }
+
+        // coarsest graph is small, keep the best of a few initial partitions
+        const partition_level& coarsest = levels.back();
+        std::vector<int> part, attempt;
+        long long best_cut = std::numeric_limits<long long>::max();
+
+        for (int i = 0; i < 8; i++) {
+                grlib::vertex_id start = i == 0 ? 0 : gen() % std::max<size_t>(1, coarsest.graph.vertices_number());
+
+                grlib::initial_partition(coarsest, pc.parts, attempt, start);
+                grlib::fm_refine(coarsest, pc.parts, max_weight, attempt);
+
+                long long cut = grlib::weighted_cut(coarsest, attempt);
+                if (cut < best_cut) {
+                        best_cut = cut;
+                        part = attempt;
+                }
+        }
+
+        for (size_t l = levels.size() - 1; l-- > 0; ) {
+                std::vector<int> finer(levels[l].graph.vertices_number());
+
+                for (size_t v = 0; v < finer.size(); v++)
+                        finer[v] = part[levels[l].coarse[v]];
+
+                part = std::move(finer);
+                grlib::fm_refine(levels[l], pc.parts, max_weight, part);
+        }
+
+        pc.part = std::move(part);
+        pc.edge_cut = 0;
+        std::fill(pc.part_size.begin(), pc.part_size.end(), 0);
+        std::fill(pc.cut_edges.begin(), pc.cut_edges.end(), 0);
+
+        for (size_t v = 0; v < n; v++) {
+                pc.part_size[pc.part[v]]++;
+
+                for (grlib::vertex_id u : pc.graph.neighbors(v))
+                        if (pc.part[u] != pc.part[v]) {
+                                pc.cut_edges[pc.part[v]]++;
+                                pc.edge_cut++;
+                        }
+        }
+
+        // every cut edge was seen from both ends
+        pc.edge_cut /= 2;
+}
+
+}; // namespace grlib
@@ -0,0 +1,288 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/grlib.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+/**
+ * Graph of strongly connected components.
+ */
+struct condensation {
+        std::vector<int> component; /// component of each vertex
+        size_t components_number = 0;
+        grlib::csr dag; /// edges between components, sorted and unique
+};
+
+/**
+ * Iterative Tarjan's algorithm on csr. Components are numbered from 0 in order of
+ * completion, which is reverse topological order: every edge of the condensation
+ * goes from a higher component to a lower one.
+ * @param graph: csr of the graph
+ * @return condensation of the graph
+ */
+inline condensation condense(const grlib::csr& graph)
+{
+        size_t n = graph.vertices_number();
+        condensation cond;
+        cond.component.assign(n, -1);
+
+        std::vector<int> index(n, -1);
+        std::vector<int> low(n);
+        std::vector<grlib::vertex_id> active;
+        std::vector<std::pair<grlib::vertex_id, size_t>> calls;
+        int counter = 0;
+
+        auto enter = [&] (grlib::vertex_id v) {
+                index[v] = low[v] = counter++;
+                active.push_back(v);
+                calls.emplace_back(v, graph.offsets[v]);
+        };
+
+        for (size_t root = 0; root < n; root++) {
+                if (index[root] >= 0)
+                        continue;
+
+                enter(root);
+
+                while (!calls.empty()) {
+                        grlib::vertex_id v = calls.back().first;
+                        size_t i = calls.back().second;
+
+                        if (i < graph.offsets[v + 1]) {
+                                grlib::vertex_id w = graph.targets[i];
+                                calls.back().second++;
+
+                                if (index[w] < 0)
+                                        enter(w);
+                                else if (cond.component[w] < 0)
+                                        low[v] = std::min(low[v], index[w]);
+
+                                continue;
+                        }
+
+                        calls.pop_back();
+
+                        if (!calls.empty()) {
+                                grlib::vertex_id u = calls.back().first;
+                                low[u] = std::min(low[u], low[v]);
+                        }
+
+                        if (low[v] == index[v]) {
+                                grlib::vertex_id t;
+
+                                do {
+                                        t = active.back();
+                                        active.pop_back();
+                                        cond.component[t] = cond.components_number;
+                                } while (t != v);
+
+                                cond.components_number++;
+                        }
+                }
+        }
+
+        size_t c = cond.components_number;
+        cond.dag = grlib::csr(c, true);
+
+        for (size_t x = 0; x < n; x++)
+                for (grlib::vertex_id y : graph.neighbors(x))
+                        if (cond.component[x] != cond.component[y])
+                                cond.dag.offsets[cond.component[x] + 1]++;
+
+        for (size_t v = 0; v < c; v++)
+                cond.dag.offsets[v + 1] += cond.dag.offsets[v];
+
+        cond.dag.targets.resize(cond.dag.offsets[c]);
+        cond.dag.weights.assign(cond.dag.offsets[c], 0);
+
+        std::vector<size_t> pos(cond.dag.offsets.begin(), cond.dag.offsets.end() - 1);
+
+        for (size_t x = 0; x < n; x++)
+                for (grlib::vertex_id y : graph.neighbors(x))
+                        if (cond.component[x] != cond.component[y])
+                                cond.dag.targets[pos[cond.component[x]]++] = cond.component[y];
+
+        grlib::sort_and_dedupe(cond.dag, true, 1);
+        return cond;
+}
+
+struct reachability_context {
+        reachability_context() = delete;
+
+        /**
+         * Initialize context, condensation of the graph is computed here
+         * @param graph: csr of the graph
+         */
+        reachability_context(const grlib::csr& graph)
+        :cond(grlib::condense(graph)),
+         words(0) { }
+
+        grlib::condensation cond;
+
+        size_t words; /// 64-bit words per row of the closure
+        std::vector<std::uint64_t> closure; /// components_number rows, bit d of row c: c reaches d
+
+        std::vector<int> post; /// post-order number of each component in the spanning forest
+        std::vector<size_t> interval_offsets; /// intervals of component c start at interval_offsets[c]
+        std::vector<std::pair<int, int>> intervals; /// disjoint, sorted ranges of reachable post numbers
+};
+
+/**
+ * Transitive closure of the condensation. Components are processed in reverse
+ * topological order and each row is the bitwise union of rows of its successors, 64
+ * components per instruction. Successors are visited from the topologically earliest
+ * one, so those already covered by a union are skipped.
+ * Memory: components_number^2 / 8 bytes.
+ * @param rc: context that algorithm will process
+ */
+inline void transitive_closure(reachability_context& rc)
+{
+        const grlib::csr& dag = rc.cond.dag;
+        size_t c = rc.cond.components_number;
+
+        rc.words = (c + 63) / 64;
+        rc.closure.assign(c * rc.words, 0);
+
+        for (size_t x = 0; x < c; x++) {
+                std::uint64_t* row = rc.closure.data() + x * rc.words;
+                row[x / 64] |= std::uint64_t(1) << (x % 64);
+
+                for (size_t i = dag.offsets[x + 1]; i-- > dag.offsets[x]; ) {
+                        grlib::vertex_id y = dag.targets[i];
+
+                        if (row[y / 64] & (std::uint64_t(1) << (y % 64)))
+                                continue;
+
+                        const std::uint64_t* other = rc.closure.data() + y * rc.words;
+                        for (size_t w = 0; w < rc.words; w++)
+                                row[w] |= other[w];
+                }
+        }
+}
+
+/**
+ * Interval labeling (Agrawal, Borgida, Jagadish) of the condensation. Components are
+ * numbered in post-order of a spanning forest, so each subtree covers a contiguous range
+ * of numbers; ranges of successors are then merged into every component. Queries binary
+ * search these ranges. The index is exact and usually much smaller than the closure.
+ * @param rc: context that algorithm will process
+ */
+inline void interval_labeling(reachability_context& rc)
+{
+        const grlib::csr& dag = rc.cond.dag;
+        size_t c = rc.cond.components_number;
+
+        std::vector<int> first(c, -1);
+        std::vector<char> has_parent(c, 0);
+        std::vector<std::pair<grlib::vertex_id, size_t>> calls;
+        int counter = 0;
+
+        rc.post.assign(c, -1);
+
+        for (grlib::vertex_id y : dag.targets)
+                has_parent[y] = 1;
+
+        // spanning forest rooted at sources of the dag
+        for (size_t root = 0; root < c; root++) {
+                if (has_parent[root])
+                        continue;
+
+                first[root] = counter;
+                calls.emplace_back(root, dag.offsets[root]);
+
+                while (!calls.empty()) {
+                        grlib::vertex_id v = calls.back().first;
+                        size_t i = calls.back().second;
+
+                        if (i < dag.offsets[v + 1]) {
+                                grlib::vertex_id w = dag.targets[i];
+                                calls.back().second++;
+
+                                if (first[w] < 0) {
+                                        first[w] = counter;
+                                        calls.emplace_back(w, dag.offsets[w]);
+                                }
+
+                                continue;
+                        }
+
+                        rc.post[v] = counter++;
+                        calls.pop_back();
+                }
+        }
+
+        // successors have lower indices, so their intervals are already final
+        std::vector<std::pair<int, int>> merged;
+
+        rc.interval_offsets.assign(c + 1, 0);
+        rc.intervals.clear();
+
+        for (size_t x = 0; x < c; x++) {
+                merged.clear();
+                merged.emplace_back(first[x], rc.post[x]);
+
+                for (grlib::vertex_id y : dag.neighbors(x))
+                        merged.insert(merged.end(),
+                                rc.intervals.begin() + rc.interval_offsets[y],
+                                rc.intervals.begin() + rc.interval_offsets[y + 1]);
+
+                std::sort(merged.begin(), merged.end());
+
+                size_t begin = rc.intervals.size();
+
+                for (const auto& range : merged) {
+                        if (rc.intervals.size() > begin and range.first <= rc.intervals.back().second + 1)
+                                rc.intervals.back().second = std::max(rc.intervals.back().second,
+                                                range.second);
+                        else
+                                rc.intervals.push_back(range);
+                }
+
+                rc.interval_offsets[x + 1] = rc.intervals.size();
+        }
+}
+
+/**
+ * Answer reachability query in O(1) using the closure, or in O(log(intervals)) using the
+ * interval labeling when closure was not built.
+ * @param rc: context with transitive_closure() or interval_labeling() computed
+ * @param u: index of the source vertex
+ * @param v: index of the target vertex
+ * @return whether there is a path u -> v
+ */
+inline bool reachable(const reachability_context& rc, grlib::vertex_id u, grlib::vertex_id v)
+{
+        int cu = rc.cond.component[u];
+        int cv = rc.cond.component[v];
+
+        if (cu == cv)
+                return true;
+
+        if (!rc.closure.empty())
+                return rc.closure[cu * rc.words + cv / 64] & (std::uint64_t(1) << (cv % 64));
+
+        if (rc.post.empty())
+                throw std::runtime_error("reachable(): no index computed");
+
+        // last interval starting at or before post number of cv
+        auto first = rc.intervals.begin() + rc.interval_offsets[cu];
+        auto last = rc.intervals.begin() + rc.interval_offsets[cu + 1];
+        int p = rc.post[cv];
+
+        auto it = std::upper_bound(first, last, p, [] (int value, const std::pair<int, int>& range) {
+                return value < range.first;
+        });
+
+        return it != first and std::prev(it)->second >= p;
+}
+
+}; // namespace grlib
@@ -0,0 +1,326 @@
+/** @file */
+#pragma once
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/grlib.hpp"
+#include "grlib/vertices_map.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+/*
+ * Orderings are returned as permutations: perm[old_id] == new_id.
+ */
+
+/**
+ * Vertices sorted by degree, ties keep original order.
+ * @param graph: csr of the graph
+ * @param descending: whether hubs get the lowest ids
+ * @return permutation of vertices
+ */
+inline std::vector<grlib::vertex_id> degree_order(const grlib::csr& graph, bool descending = true)
+{
+        size_t n = graph.vertices_number();
+        std::vector<grlib::vertex_id> order(n);
+        std::iota(order.begin(), order.end(), 0);
+
+        std::stable_sort(order.begin(), order.end(), [&] (grlib::vertex_id a, grlib::vertex_id b) {
+                return descending ? graph.degree(a) > graph.degree(b) : graph.degree(a) < graph.degree(b);
+        });
+
+        std::vector<grlib::vertex_id> perm(n);
+        for (size_t i = 0; i < n; i++)
+                perm[order[i]] = i;
+
+        return perm;
+}
+
+/**
+ * Reverse Cuthill-McKee ordering. Each connected component is traversed breadth-first
+ * from a pseudo-peripheral vertex, visiting neighbors by increasing degree; the whole
+ * order is then reversed. Keeps edges close to the diagonal (small bandwidth).
+ * @param graph: csr of the graph, direction of edges is ignored
+ * @return permutation of vertices
+ */
+inline std::vector<grlib::vertex_id> rcm_order(const grlib::csr& graph)
+{
+        grlib::csr sym = grlib::symmetrize(graph, 1);
+        size_t n = sym.vertices_number();
+
+        std::vector<grlib::vertex_id> order;
+        std::vector<int> dist(n, -1);
+        std::vector<char> placed(n, 0);
+        std::vector<grlib::vertex_id> queue, next;
+        order.reserve(n);
+
+        // BFS over the component of v, returns depth of the last level
+        auto levels = [&] (grlib::vertex_id v) {
+                for (grlib::vertex_id u : queue)
+                        dist[u] = -1;
+
+                queue.assign(1, v);
+                dist[v] = 0;
+
+                for (size_t head = 0; head < queue.size(); head++)
+                        for (grlib::vertex_id u : sym.neighbors(queue[head]))
+                                if (dist[u] < 0) {
+                                        dist[u] = dist[queue[head]] + 1;
+                                        queue.push_back(u);
+                                }
+
+                return dist[queue.back()];
+        };
+
+        std::vector<grlib::vertex_id> by_degree(n);
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&] (grlib::vertex_id a, grlib::vertex_id b) {
+                return sym.degree(a) < sym.degree(b);
+        });
+
+        for (grlib::vertex_id root : by_degree) {
+                if (placed[root])
+                        continue;
+
+                // George-Liu pseudo-peripheral vertex: move to the lowest degree vertex
+                // of the last level while eccentricity grows
+                grlib::vertex_id start = root;
+                int eccentricity = levels(start);
+
+                while (true) {
+                        grlib::vertex_id candidate = queue.back();
+
+                        for (size_t i = queue.size(); i-- > 0 and dist[queue[i]] == eccentricity; )
+                                if (sym.degree(queue[i]) < sym.degree(candidate))
+                                        candidate = queue[i];
+
+                        int depth = levels(candidate);
+                        if (depth <= eccentricity)
+                                break;
+
+                        start = candidate;
+                        eccentricity = depth;
+                }
+
+                for (grlib::vertex_id u : queue)
+                        dist[u] = -1;
+                queue.clear();
+
+                // Cuthill-McKee from start
+                size_t first = order.size();
+                order.push_back(start);
+                placed[start] = 1;
+
+                for (size_t head = first; head < order.size(); head++) {
+                        next.clear();
+                        for (grlib::vertex_id u : sym.neighbors(order[head]))
+                                if (!placed[u]) {
+                                        placed[u] = 1;
+                                        next.push_back(u);
+                                }
+
+                        std::stable_sort(next.begin(), next.end(), [&] (grlib::vertex_id a, grlib::vertex_id b) {
+                                return sym.degree(a) < sym.degree(b);
+                        });
+
+                        order.insert(order.end(), next.begin(), next.end());
+                }
+        }
+
+        std::vector<grlib::vertex_id> perm(n);
+        for (size_t i = 0; i < n; i++)
+                perm[order[i]] = n - 1 - i;
+
+        return perm;
+}
+
+/**
+ * Gorder-style greedy ordering (Wei et al.). Vertices are placed one by one, the next
+ * one maximizing its score against the window of last placed vertices: one point for
+ * every edge to a vertex of the window and for every in-window vertex sharing
+ * a neighbor. Scores are updated incrementally when a vertex enters or leaves the
+ * window; neighbors with degree above sqrt(V) are not expanded, which keeps the cost
+ * close to O(E * window).
+ * @param graph: csr of the graph, direction of edges is ignored
+ * @param window: number of recently placed vertices taken into account
+ * @return permutation of vertices
+ */
+inline std::vector<grlib::vertex_id> gorder_order(const grlib::csr& graph, size_t window = 5)
+{
+        grlib::csr sym = grlib::symmetrize(graph, 1);
+        size_t n = sym.vertices_number();
+        size_t hub = static_cast<size_t>(std::sqrt(static_cast<double>(n))) + 1;
+
+        std::vector<int> score(n, 0);
+        std::vector<char> placed(n, 0);
+        std::vector<grlib::vertex_id> order;
+        order.reserve(n);
+
+        // max-heap with lazy deletion: entries whose score is outdated are skipped
+        std::vector<std::pair<int, grlib::vertex_id>> heap;
+
+        auto update = [&] (grlib::vertex_id v, int delta) {
+                for (grlib::vertex_id u : sym.neighbors(v)) {
+                        if (!placed[u]) {
+                                score[u] += delta;
+                                heap.emplace_back(score[u], u);
+                                std::push_heap(heap.begin(), heap.end());
+                        }
+
+                        if (sym.degree(u) > hub)
+                                continue;
+
+                        for (grlib::vertex_id w : sym.neighbors(u))
+                                if (!placed[w] and w != v) {
+                                        score[w] += delta;
+                                        heap.emplace_back(score[w], w);
+                                        std::push_heap(heap.begin(), heap.end());
+                                }
+                }
+        };
+
+        std::vector<grlib::vertex_id> by_degree(n);
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&] (grlib::vertex_id a, grlib::vertex_id b) {
+                return sym.degree(a) > sym.degree(b);
+        });
+        size_t fallback = 0;
+
+        while (order.size() < n) {
+                grlib::vertex_id v = -1;
+
+                while (!heap.empty()) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        auto top = heap.back();
+                        heap.pop_back();
+
+                        if (!placed[top.second] and top.first == score[top.second] and top.first > 0) {
+                                v = top.second;
+                                break;
+                        }
+                }
+
+                // nothing related to the window, continue from the highest degree vertex left
+                if (v < 0) {
+                        while (placed[by_degree[fallback]])
+                                fallback++;
+                        v = by_degree[fallback];
+                }
+
+                placed[v] = 1;
+                order.push_back(v);
+                update(v, 1);
+
+                if (order.size() > window)
+                        update(order[order.size() - window - 1], -1);
+        }
+
+        std::vector<grlib::vertex_id> perm(n);
+        for (size_t i = 0; i < n; i++)
+                perm[order[i]] = i;
+
+        return perm;
+}
+
+/**
+ * Relabel csr: vertex v becomes perm[v]. Neighbors of every vertex are sorted.
+ * @param graph: csr to be relabeled
+ * @param perm: permutation of vertices
+ * @return relabeled csr
+ */
+inline grlib::csr permute(const grlib::csr& graph, const std::vector<grlib::vertex_id>& perm)
+{
+        size_t n = graph.vertices_number();
+
+        if (perm.size() != n)
+                throw std::runtime_error("permute(): invalid size of permutation");
+
+        grlib::csr result(n, graph.directed);
+
+        for (size_t v = 0; v < n; v++)
+                result.offsets[perm[v] + 1] = graph.degree(v);
+
+        for (size_t v = 0; v < n; v++)
+                result.offsets[v + 1] += result.offsets[v];
+
+        result.targets.resize(graph.edges_number());
+        result.weights.resize(graph.edges_number());
+
+        for (size_t v = 0; v < n; v++) {
+                size_t pos = result.offsets[perm[v]];
+                std::vector<std::pair<grlib::vertex_id, int>> list;
+
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++)
+                        list.emplace_back(perm[graph.targets[i]], graph.weights[i]);
+
+                std::sort(list.begin(), list.end());
+
+                for (const auto& edge : list) {
+                        result.targets[pos] = edge.first;
+                        result.weights[pos] = edge.second;
+                        pos++;
+                }
+        }
+
+        return result;
+}
+
+/**
+ * Relabel adjacency list and its vertices map in place: vertex v becomes perm[v],
+ * names keep pointing to the same vertices.
+ * @param alist: adjacency list to be relabeled
+ * @param perm: permutation of vertices, e.g. of make_csr(alist); its size is between
+ * alist.vertices_number() and alist.vertices_capacity(), unused slots beyond it stay in place
+ */
+template<typename Edge, typename Alloc>
+void permute(grlib::adj_list<Edge, Alloc>& alist, const std::vector<grlib::vertex_id>& perm)
+{
+        size_t n = alist.vertices_capacity();
+        size_t m = perm.size();
+
+        if (m > n or m < alist.vertices_number())
+                throw std::runtime_error("permute(): invalid size of permutation");
+
+        auto to = [&] (size_t v) -> size_t { return v < m ? perm[v] : v; };
+
+        std::vector<typename grlib::adj_list<Edge, Alloc>::list_type> edges(n,
+                        typename grlib::adj_list<Edge, Alloc>::list_type(alist.allocator));
+
+        for (size_t v = 0; v < n; v++) {
+                for (auto& edge : alist.edges[v])
+                        edge.y = to(edge.y);
+
+                edges[to(v)] = std::move(alist.edges[v]);
+        }
+
+        alist.edges = std::move(edges);
+
+        grlib::Vertices_map& vmap = alist.vmap;
+        std::vector<std::string> names(std::max(vmap.names.size(), n));
+
+        for (size_t v = 0; v < vmap.names.size(); v++)
+                names[to(v)] = std::move(vmap.names[v]);
+
+        vmap.names = std::move(names);
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        std::vector<Agnode_t*> nodes(std::max(vmap.nodes.size(), n), nullptr);
+
+        for (size_t v = 0; v < vmap.nodes.size(); v++)
+                nodes[to(v)] = vmap.nodes[v];
+
+        vmap.nodes = std::move(nodes);
+#endif
+
+        for (auto& p : vmap.indexes)
+                p.second = to(p.second);
+}
+
+}; // namespace grlib
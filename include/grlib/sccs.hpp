@@ -11,10 +11,10 @@
 
 namespace grlib {
 
-template<typename edge>
+template<typename edge, typename Alloc = std::allocator<edge>>
 struct sccs_context {
         sccs_context() = delete;
-        sccs_context(grlib::adj_list<edge>& alist)
+        sccs_context(grlib::adj_list<edge, Alloc>& alist)
         :alist(&alist),
          components_number(0),
          low(alist.vertices_capacity()),
@@ -23,15 +23,15 @@ struct sccs_context {
                 std::iota(low.begin(), low.end(), 0);
         }
 
-        grlib::adj_list<edge>* alist;
+        grlib::adj_list<edge, Alloc>* alist;
         int components_number;
 
         std::vector<int> low;
         std::vector<int> scc;
 };
 
-template<typename T>
-Edge_type edge_classification(int x, int y, dfs_context<T>& dfs)
+template<typename T, typename Alloc>
+Edge_type edge_classification(int x, int y, dfs_context<T, Alloc>& dfs)
 {
         if (dfs.parent(y) == x)
                 return Edge_type::tree;
@@ -49,11 +49,11 @@ Edge_type edge_classification(int x, int y, dfs_context<T>& dfs)
  * Tarjan's strongly connected components algorithm
  * @param sccs: context that algorithm will process
  */
-template<typename T>
-void sccs(sccs_context<T>& sccs)
+template<typename T, typename Alloc>
+void sccs(sccs_context<T, Alloc>& sccs)
 {
-        grlib::adj_list<T>& alist = *sccs.alist;
-        using dfs_cxt = dfs_context<T>&;
+        grlib::adj_list<T, Alloc>& alist = *sccs.alist;
+        using dfs_cxt = dfs_context<T, Alloc>&;
 
         std::stack<int> active;
 
@@ -95,7 +95,7 @@ void sccs(sccs_context<T>& sccs)
                         sccs.low[dfs.parent(v)] = sccs.low[v];
         };
 
-        grlib::dfs_context<T> dfs_context(*sccs.alist, 0,
+        grlib::dfs_context<T, Alloc> dfs_context(*sccs.alist, 0,
                 process_vertex_early, process_edge, process_vertex_late);
 
         for (size_t i = 0; i < alist.edges.size(); i++)
@@ -0,0 +1,347 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/grlib.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace grlib {
+
+/**
+ * Reusable state of Dijkstra-like search. Only vertices touched by the previous
+ * query are reset, so a query costs O(touched * log(touched)) regardless of graph size.
+ */
+struct dijkstra_workspace {
+        static constexpr long long infinity = std::numeric_limits<long long>::max();
+
+        dijkstra_workspace() = default;
+
+        /**
+         * Initialize workspace
+         * @param vertices: number of vertices of searched graphs
+         */
+        dijkstra_workspace(size_t vertices)
+        : dist(vertices, infinity), parent(vertices, -1), settled(vertices, 0) { }
+
+        /**
+         * Forget previous search
+         */
+        void reset()
+        {
+                for (grlib::vertex_id v : touched) {
+                        dist[v] = infinity;
+                        parent[v] = -1;
+                        settled[v] = 0;
+                }
+
+                touched.clear();
+                heap.clear();
+        }
+
+        /**
+         * Set tentative distance of the vertex and queue it
+         * @param v: index of the vertex
+         * @param d: new distance
+         * @param p: parent of the vertex on the path
+         * @param key: priority in the queue
+         */
+        void relax(grlib::vertex_id v, long long d, grlib::vertex_id p, long long key)
+        {
+                if (dist[v] == infinity)
+                        touched.push_back(v);
+
+                dist[v] = d;
+                parent[v] = p;
+                heap.emplace_back(key, v);
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
+        }
+
+        /**
+         * @return vertex with the lowest key, removed from the queue
+         */
+        std::pair<long long, grlib::vertex_id> pop()
+        {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+                auto top = heap.back();
+                heap.pop_back();
+                return top;
+        }
+
+        std::vector<long long> dist; /// tentative distance from the root
+        std::vector<grlib::vertex_id> parent; /// parent on the shortest path, -1 for root
+        std::vector<char> settled; /// distance is final
+        std::vector<grlib::vertex_id> touched; /// vertices with finite distance
+        std::vector<std::pair<long long, grlib::vertex_id>> heap; /// queue with lazy deletion
+};
+
+/**
+ * Heuristic of plain Dijkstra search.
+ */
+struct zero_heuristic {
+        long long operator()([[maybe_unused]] grlib::vertex_id v,
+                        [[maybe_unused]] grlib::vertex_id target) const
+        {
+                return 0;
+        }
+};
+
+/**
+ * Straight-line distance between vertex coordinates. It is consistent as long as
+ * weight of every edge is at least scale * length of the edge.
+ */
+struct euclidean_heuristic {
+        /**
+         * @param pos: coordinates of each vertex
+         * @param scale: multiplier converting coordinates into weights
+         */
+        euclidean_heuristic(const std::vector<std::pair<double, double>>& pos, double scale = 1.0)
+        : pos(&pos), scale(scale) { }
+
+        long long operator()(grlib::vertex_id v, grlib::vertex_id target) const
+        {
+                double dx = (*pos)[v].first - (*pos)[target].first;
+                double dy = (*pos)[v].second - (*pos)[target].second;
+                return static_cast<long long>(std::floor(scale * std::sqrt(dx * dx + dy * dy)));
+        }
+
+        const std::vector<std::pair<double, double>>* pos;
+        double scale;
+};
+
+/**
+ * Largest scale for which euclidean_heuristic stays consistent on the graph.
+ * @param graph: csr of the graph
+ * @param pos: coordinates of each vertex
+ * @return minimum of weight / length over all edges of non-zero length
+ */
+inline double consistent_scale(const grlib::csr& graph,
+                const std::vector<std::pair<double, double>>& pos)
+{
+        double scale = std::numeric_limits<double>::max();
+
+        for (size_t x = 0; x < graph.vertices_number(); x++)
+                for (size_t i = graph.offsets[x]; i < graph.offsets[x + 1]; i++) {
+                        grlib::vertex_id y = graph.targets[i];
+                        double len = std::hypot(pos[x].first - pos[y].first,
+                                        pos[x].second - pos[y].second);
+
+                        if (len > 0.0)
+                                scale = std::min(scale, graph.weights[i] / len);
+                }
+
+        return scale == std::numeric_limits<double>::max() ? 0.0 : std::max(scale, 0.0);
+}
+
+struct shortest_path_context {
+        shortest_path_context() = delete;
+
+        /**
+         * Initialize context, shared by many queries on the same graph
+         * @param graph: csr of the graph with non-negative weights
+         */
+        shortest_path_context(const grlib::csr& graph)
+        :forward(&graph),
+         backward(grlib::transpose(graph)),
+         fw(graph.vertices_number()),
+         bw(graph.vertices_number()),
+         source(-1),
+         target(-1),
+         meeting(-1),
+         distance(dijkstra_workspace::infinity)
+        {
+                for (int w : graph.weights)
+                        if (w < 0)
+                                throw std::runtime_error("shortest_path_context(): negative weight");
+        }
+
+        const grlib::csr* forward;
+        grlib::csr backward; /// transposed graph for backward search
+        grlib::dijkstra_workspace fw; /// forward search state
+        grlib::dijkstra_workspace bw; /// backward search state
+
+        grlib::vertex_id source; /// source of the last query
+        grlib::vertex_id target; /// target of the last query
+        grlib::vertex_id meeting; /// vertex where searches met, -1 for one-directional query
+        long long distance; /// result of the last query, infinity when unreachable
+};
+
+/**
+ * A* point-to-point search. Heuristic must be consistent, Dijkstra when it is zero.
+ * @param sp: context of the queries
+ * @param s: index of source vertex
+ * @param t: index of target vertex
+ * @param h: heuristic, h(v, t) estimates distance v -> t from below
+ * @return length of shortest path, infinity when t is unreachable
+ */
+template<typename Heuristic = grlib::zero_heuristic>
+long long astar(shortest_path_context& sp, grlib::vertex_id s, grlib::vertex_id t,
+                Heuristic&& h = Heuristic())
+{
+        const grlib::csr& graph = *sp.forward;
+        grlib::dijkstra_workspace& ws = sp.fw;
+
+        sp.fw.reset();
+        sp.bw.reset();
+        sp.source = s;
+        sp.target = t;
+        sp.meeting = -1;
+        sp.distance = dijkstra_workspace::infinity;
+
+        ws.relax(s, 0, -1, h(s, t));
+
+        while (!ws.heap.empty()) {
+                grlib::vertex_id v = ws.pop().second;
+
+                if (ws.settled[v])
+                        continue;
+
+                ws.settled[v] = 1;
+
+                if (v == t) {
+                        sp.distance = ws.dist[t];
+                        break;
+                }
+
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                        grlib::vertex_id w = graph.targets[i];
+                        long long nd = ws.dist[v] + graph.weights[i];
+
+                        if (nd < ws.dist[w])
+                                ws.relax(w, nd, v, nd + h(w, t));
+                }
+        }
+
+        return sp.distance;
+}
+
+/**
+ * Bidirectional Dijkstra search. Side with the smaller queue key is expanded; search
+ * stops when sum of both keys reaches length of the best path found so far.
+ * @param sp: context of the queries
+ * @param s: index of source vertex
+ * @param t: index of target vertex
+ * @return length of shortest path, infinity when t is unreachable
+ */
+inline long long bidirectional_dijkstra(shortest_path_context& sp, grlib::vertex_id s,
+                grlib::vertex_id t)
+{
+        sp.fw.reset();
+        sp.bw.reset();
+        sp.source = s;
+        sp.target = t;
+        sp.meeting = s == t ? s : -1;
+        sp.distance = s == t ? 0 : dijkstra_workspace::infinity;
+
+        if (s == t)
+                return 0;
+
+        sp.fw.relax(s, 0, -1, 0);
+        sp.bw.relax(t, 0, -1, 0);
+
+        auto expand = [&sp] (const grlib::csr& graph, grlib::dijkstra_workspace& ws,
+                        grlib::dijkstra_workspace& other) {
+                grlib::vertex_id v = ws.pop().second;
+
+                if (ws.settled[v])
+                        return;
+
+                ws.settled[v] = 1;
+
+                for (size_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                        grlib::vertex_id w = graph.targets[i];
+                        long long nd = ws.dist[v] + graph.weights[i];
+
+                        if (nd < ws.dist[w])
+                                ws.relax(w, nd, v, nd);
+
+                        if (other.dist[w] != dijkstra_workspace::infinity
+                                        and ws.dist[w] + other.dist[w] < sp.distance) {
+                                sp.distance = ws.dist[w] + other.dist[w];
+                                sp.meeting = w;
+                        }
+                }
+        };
+
+        while (!sp.fw.heap.empty() and !sp.bw.heap.empty()) {
+                long long kf = sp.fw.heap.front().first;
+                long long kb = sp.bw.heap.front().first;
+
+                if (sp.distance != dijkstra_workspace::infinity and kf + kb >= sp.distance)
+                        break;
+
+                if (kf <= kb)
+                        expand(*sp.forward, sp.fw, sp.bw);
+                else
+                        expand(sp.backward, sp.bw, sp.fw);
+        }
+
+        return sp.distance;
+}
+
+/**
+ * Vertices of the path found by the last query.
+ * @param sp: context of the queries
+ * @return vertices from source to target, empty when target is unreachable
+ */
+inline std::vector<grlib::vertex_id> shortest_path(const shortest_path_context& sp)
+{
+        std::vector<grlib::vertex_id> path;
+
+        if (sp.distance == dijkstra_workspace::infinity)
+                return path;
+
+        grlib::vertex_id last = sp.meeting >= 0 ? sp.meeting : sp.target;
+
+        for (grlib::vertex_id v = last; v >= 0; v = sp.fw.parent[v])
+                path.push_back(v);
+
+        std::reverse(path.begin(), path.end());
+
+        if (sp.meeting >= 0)
+                for (grlib::vertex_id v = sp.bw.parent[sp.meeting]; v >= 0; v = sp.bw.parent[v])
+                        path.push_back(v);
+
+        return path;
+}
+
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+
+/**
+ * Read coordinates of nodes computed by Graphviz layout. Layout keeps them in node
+ * records, the "pos" attribute is written only by rendering to dot format; it is read
+ * for nodes of a graph which is not laid out, e.g. positions given in the file.
+ * @param cgraph: Graphviz graph after layout
+ * @param vmap: vertices map used for indexing
+ * @return coordinates of each vertex in points, (0, 0) when position is not defined
+ */
+inline std::vector<std::pair<double, double>> node_positions(gviz::cgraph& cgraph,
+                grlib::Vertices_map& vmap)
+{
+        std::vector<std::pair<double, double>> pos(vmap.names.size(), {0.0, 0.0});
+        Agsym_t* pos_attr = agattr(cgraph.data(), AGNODE, const_cast<char*>("pos"), nullptr);
+
+        for (gviz::Node node : cgraph) {
+                Agnode_t* n = node.data();
+                grlib::vertex_id v = vmap.index(node.name());
+                double x, y;
+
+                if (aggetrec(n, const_cast<char*>("Agnodeinfo_t"), 0))
+                        pos[v] = {ND_coord(n).x, ND_coord(n).y};
+                else if (pos_attr and sscanf(agxget(n, pos_attr), "%lf,%lf", &x, &y) == 2)
+                        pos[v] = {x, y};
+        }
+
+        return pos;
+}
+
+#endif
+
+}; // namespace grlib
@@ -0,0 +1,211 @@
+/** @file */
+#pragma once
+
+#include "grlib/csr.hpp"
+#include "grlib/parallel.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace grlib {
+
+/**
+ * Intersection of two sorted lists of unique vertices. With SSE2 available, blocks of
+ * four elements of both lists are compared all-against-all in a single step.
+ * @param a: first list
+ * @param na: size of the first list
+ * @param b: second list
+ * @param nb: size of the second list
+ * @param on_match: callback invoked with each common vertex
+ */
+template<typename Func>
+void intersect_sorted(const grlib::vertex_id* a, size_t na, const grlib::vertex_id* b,
+                size_t nb, Func&& on_match)
+{
+        size_t i = 0, j = 0;
+
+#ifdef __SSE2__
+        static_assert(sizeof(grlib::vertex_id) == 4, "SSE2 path compares 32-bit ids");
+
+        while (i + 4 <= na and j + 4 <= nb) {
+                __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+                __m128i cmp = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                                _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                        _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                                _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(cmp));
+
+                for (; mask; mask &= mask - 1)
+                        on_match(a[i + __builtin_ctz(mask)]);
+
+                grlib::vertex_id amax = a[i + 3], bmax = b[j + 3];
+
+                if (amax <= bmax)
+                        i += 4;
+                if (bmax <= amax)
+                        j += 4;
+        }
+#endif
+
+        while (i < na and j < nb) {
+                if (a[i] < b[j]) {
+                        i++;
+                } else if (b[j] < a[i]) {
+                        j++;
+                } else {
+                        on_match(a[i]);
+                        i++;
+                        j++;
+                }
+        }
+}
+
+struct triangles_context {
+        triangles_context() = delete;
+
+        /**
+         * Initialize context. Graph is treated as undirected, multiple edges and
+         * self-loops are ignored.
+         * @param graph: csr of the graph
+         * @param threads: number of threads used by the algorithm
+         */
+        triangles_context(const grlib::csr& graph, unsigned threads = grlib::default_threads())
+        :graph(grlib::symmetrize(graph, threads)),
+         threads(threads),
+         triangles_number(0),
+         triangles(graph.vertices_number(), 0),
+         clustering(graph.vertices_number(), 0.0),
+         average_clustering(0.0),
+         transitivity(0.0) { }
+
+        grlib::csr graph; /// undirected graph with sorted, unique neighbors
+        unsigned threads;
+
+        uint64_t triangles_number; /// number of triangles in the graph
+        std::vector<uint64_t> triangles; /// number of triangles each vertex belongs to
+        std::vector<double> clustering; /// local clustering coefficient of each vertex
+        double average_clustering; /// mean of local clustering coefficients
+        double transitivity; /// 3 * triangles / connected triples
+};
+
+/**
+ * Orient every undirected edge from the endpoint of lower degree to the one of higher
+ * degree (ties broken by id). Each vertex keeps O(sqrt(E)) out-neighbors, and every
+ * triangle is seen exactly once.
+ * @param graph: undirected csr with sorted neighbors
+ * @return oriented csr, neighbors stay sorted
+ */
+inline grlib::csr degree_oriented(const grlib::csr& graph)
+{
+        size_t n = graph.vertices_number();
+        grlib::csr dag(n, true);
+
+        auto before = [&] (grlib::vertex_id u, grlib::vertex_id v) {
+                size_t du = graph.degree(u), dv = graph.degree(v);
+                return du < dv or (du == dv and u < v);
+        };
+
+        for (size_t u = 0; u < n; u++) {
+                size_t count = 0;
+                for (grlib::vertex_id v : graph.neighbors(u))
+                        count += before(u, v);
+                dag.offsets[u + 1] = dag.offsets[u] + count;
+        }
+
+        dag.targets.resize(dag.offsets[n]);
+
+        for (size_t u = 0; u < n; u++) {
+                size_t pos = dag.offsets[u];
+                for (grlib::vertex_id v : graph.neighbors(u))
+                        if (before(u, v))
+                                dag.targets[pos++] = v;
+        }
+
+        dag.weights.assign(dag.targets.size(), 0);
+        return dag;
+}
+
+/**
+ * Count triangles globally and per vertex, then compute clustering coefficients.
+ * Each thread counts into its own per-vertex array, merged at the end.
+ * @param tc: context that algorithm will process
+ */
+inline void triangles(triangles_context& tc)
+{
+        const grlib::csr& graph = tc.graph;
+        size_t n = graph.vertices_number();
+        grlib::csr dag = grlib::degree_oriented(graph);
+
+        auto bounds = grlib::partition_by_edges(dag.offsets, tc.threads);
+        unsigned parts = bounds.size() - 1;
+
+        std::vector<std::vector<uint64_t>> local(parts);
+        std::vector<uint64_t> totals(parts, 0);
+
+        grlib::parallel_for(bounds, [&] (unsigned part, grlib::vertex_id begin,
+                                grlib::vertex_id end) {
+                std::vector<uint64_t>& count = local[part];
+                count.assign(n, 0);
+                uint64_t total = 0;
+
+                for (grlib::vertex_id u = begin; u < end; u++) {
+                        auto nu = dag.neighbors(u);
+
+                        for (grlib::vertex_id v : nu) {
+                                auto nv = dag.neighbors(v);
+                                uint64_t found = 0;
+
+                                grlib::intersect_sorted(nu.begin(), nu.size(), nv.begin(), nv.size(),
+                                        [&] (grlib::vertex_id w) {
+                                                count[w]++;
+                                                found++;
+                                        });
+
+                                count[u] += found;
+                                count[v] += found;
+                                total += found;
+                        }
+                }
+
+                totals[part] = total;
+        });
+
+        tc.triangles_number = 0;
+        for (unsigned i = 0; i < parts; i++)
+                tc.triangles_number += totals[i];
+
+        grlib::parallel_for(grlib::partition_evenly(n, tc.threads), [&] (
+                                [[maybe_unused]] unsigned part, grlib::vertex_id begin,
+                                grlib::vertex_id end) {
+                for (grlib::vertex_id v = begin; v < end; v++) {
+                        uint64_t t = 0;
+                        for (unsigned i = 0; i < parts; i++)
+                                t += local[i][v];
+
+                        tc.triangles[v] = t;
+
+                        double d = graph.degree(v);
+                        tc.clustering[v] = d < 2 ? 0.0 : 2.0 * t / (d * (d - 1));
+                }
+        });
+
+        double sum = 0.0, triples = 0.0;
+        for (size_t v = 0; v < n; v++) {
+                double d = graph.degree(v);
+                sum += tc.clustering[v];
+                triples += d * (d - 1) / 2;
+        }
+
+        tc.average_clustering = n ? sum / n : 0.0;
+        tc.transitivity = triples > 0 ? 3.0 * tc.triangles_number / triples : 0.0;
+}
+
+}; // namespace grlib
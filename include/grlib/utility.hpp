@@ -3,9 +3,34 @@
 
 #include <random>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
+/**
+ * Random integer from [min, max]. Every thread owns its generator, so the function is
+ * safe to call concurrently.
+ */
 int randomize(int min,int max);
 
+/**
+ * Make randomize() deterministic: generator of each thread is reseeded with
+ * seed combined with index of the thread in order of first use after this call.
+ * @param seed: new seed
+ */
+void seed_randomize(unsigned seed);
+
+/**
+ * Generate any number of distinct colors. Hue advances by the golden ratio, so
+ * consecutive colors are far apart; saturation and value follow their own
+ * low-discrepancy sequence, so no two colors repeat the same (s, v) band and
+ * hundreds of thousands of classes get distinct colors.
+ * @param n: number of colors
+ * @param offset: index of the first generated color in the sequence
+ * @return unique colors in "#RRGGBB" format
+ * Throws the exception if 8-bit RGB has not enough distinct colors left
+ */
+std::vector<std::string> generate_palette(size_t n, size_t offset = 0);
+
 struct Color_pool {
         using Color = std::pair<std::string, bool>;
 
@@ -47,6 +72,22 @@ struct Color_pool {
                 colors.emplace_back("#F95738", false);
         }
 
+        /**
+         * Initialize pool with predefined colors, extended with generated ones
+         * @param n: number of colors that pool has to provide
+         */
+        Color_pool(size_t n)
+        : Color_pool()
+        {
+                if (n <= colors.size())
+                        return;
+
+                std::vector<std::string> extra = generate_palette(n - colors.size());
+
+                for (auto& color : extra)
+                        colors.emplace_back(std::move(color), false);
+        }
+
 
         /**
          * Function returns next not used color
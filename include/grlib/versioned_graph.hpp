@@ -0,0 +1,249 @@
+/** @file */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/dynamic_graph.hpp"
+
+namespace grlib {
+
+/**
+ * Immutable state of versioned_graph. Readers keep a shared_ptr to it, so it lives as long
+ * as anybody traverses it, and it never changes under them.
+ * Vertices are grouped into chunks of chunk_size; a chunk points to an immutable edge
+ * list of each of its vertices. A new version shares all untouched chunks and lists
+ * with the previous one.
+ */
+template<typename Edge>
+struct graph_version {
+        static constexpr size_t chunk_bits = 6;
+        static constexpr size_t chunk_size = size_t(1) << chunk_bits;
+
+        using edge_list = std::vector<Edge>;
+
+        struct chunk {
+                std::array<std::shared_ptr<const edge_list>, chunk_size> lists;
+        };
+
+        size_t vertices_number() const { return vertices; }
+        size_t edges_number() const { return arcs; }
+
+        /**
+         * @return edges leaving the vertex
+         */
+        const edge_list& edges(grlib::vertex_id v) const
+        {
+                return *chunks[v >> chunk_bits]->lists[v & (chunk_size - 1)];
+        }
+
+        edge_target_range<Edge> neighbors(grlib::vertex_id v) const
+        {
+                const edge_list& list = edges(v);
+                return {list.data(), list.data() + list.size()};
+        }
+
+        std::vector<std::shared_ptr<const chunk>> chunks;
+        size_t vertices = 0;
+        size_t arcs = 0; /// number of stored arcs, undirected edges are stored twice
+        bool directed = false;
+        size_t number = 0; /// number of the version, incremented by every batch
+};
+
+/**
+ * Graph with one writer and many readers. Readers take snapshot() and run any
+ * algorithm on it without locks; writers prepare a new version by copying only the
+ * chunks and edge lists touched by the batch, then publish it atomically. Old versions
+ * are released when the last snapshot referring to them is dropped.
+ */
+template<typename Edge = grlib::Basic_edge>
+struct versioned_graph {
+        using version = graph_version<Edge>;
+        using snapshot_ptr = std::shared_ptr<const version>;
+
+        /**
+         * Define graph attribute
+         * @param vertices: number of vertices
+         * @param directed: whether graph is directed
+         */
+        versioned_graph(size_t vertices = 0, bool directed = false)
+        : empty(std::make_shared<const typename version::edge_list>())
+        {
+                auto first = std::make_shared<version>();
+                first->directed = directed;
+                grow(*first, vertices);
+                std::atomic_store(&head, snapshot_ptr(std::move(first)));
+        }
+
+        /**
+         * Initialize with edges of the adjacency list, ids are kept
+         * @param alist: adjacency list
+         */
+        template<typename Alloc>
+        versioned_graph(const grlib::adj_list<Edge, Alloc>& alist)
+        : versioned_graph(alist.vertices_capacity(), alist.directed)
+        {
+                std::vector<std::pair<grlib::vertex_id, Edge>> arcs;
+                arcs.reserve(alist.edges_number());
+
+                for (size_t v = 0; v < alist.vertices_capacity(); v++)
+                        for (const auto& edge : alist.edges[v])
+                                arcs.emplace_back(v, edge);
+
+                // adj_list keeps both arcs of undirected edges already
+                std::lock_guard<std::mutex> lock(writer);
+                apply(std::move(arcs));
+        }
+
+        /**
+         * @return current version, safe to call from any thread
+         */
+        snapshot_ptr snapshot() const
+        {
+                return std::atomic_load(&head);
+        }
+
+        /**
+         * Insert x -> y edges (and y -> x ones in undirected graph) as one new version.
+         * Vertices beyond the current range are added. Readers are never blocked;
+         * concurrent writers are serialized.
+         * @param batch: pairs of the first vertex and the edge
+         */
+        void insert_edges(const std::vector<std::pair<grlib::vertex_id, Edge>>& batch)
+        {
+                std::vector<std::pair<grlib::vertex_id, Edge>> arcs(batch);
+
+                if (!snapshot()->directed)
+                        for (const auto& arc : batch)
+                                if (arc.first != arc.second.y) {
+                                        Edge back = arc.second;
+                                        back.y = arc.first;
+                                        arcs.emplace_back(arc.second.y, back);
+                                }
+
+                std::lock_guard<std::mutex> lock(writer);
+                apply(std::move(arcs));
+        }
+
+        /**
+         * Insert single edge as a new version, see insert_edges()
+         * @param x: index of first vertex
+         * @param edge: weight structure of the graph
+         */
+        void insert_edge(grlib::vertex_id x, const Edge& edge)
+        {
+                insert_edges({{x, edge}});
+        }
+
+private:
+        /**
+         * Publish new version with arcs added, writer lock must be held
+         * @param arcs: pairs of the first vertex and the edge
+         */
+        void apply(std::vector<std::pair<grlib::vertex_id, Edge>> arcs)
+        {
+                auto next = std::make_shared<version>(*snapshot());
+                next->number++;
+
+                size_t range = next->vertices;
+                for (const auto& arc : arcs)
+                        range = std::max<size_t>(range, std::max(arc.first, arc.second.y) + 1);
+                grow(*next, range);
+
+                std::stable_sort(arcs.begin(), arcs.end(), [] (const auto& a, const auto& b) {
+                        return a.first < b.first;
+                });
+
+                // arcs are sorted, so each touched chunk is copied once; others stay shared
+                typename version::chunk* current = nullptr;
+                size_t current_index = 0;
+
+                for (size_t i = 0; i < arcs.size(); ) {
+                        grlib::vertex_id v = arcs[i].first;
+                        size_t c = v >> version::chunk_bits;
+
+                        if (!current or c != current_index) {
+                                auto copy = std::make_shared<typename version::chunk>(*next->chunks[c]);
+                                current = copy.get();
+                                current_index = c;
+                                next->chunks[c] = std::move(copy);
+                        }
+
+                        auto& slot = current->lists[v & (version::chunk_size - 1)];
+                        auto list = std::make_shared<typename version::edge_list>();
+
+                        size_t j = i;
+                        while (j < arcs.size() and arcs[j].first == v)
+                                j++;
+
+                        list->reserve(slot->size() + j - i);
+                        list->insert(list->end(), slot->begin(), slot->end());
+                        for (; i < j; i++)
+                                list->push_back(arcs[i].second);
+
+                        next->arcs += list->size() - slot->size();
+                        slot = std::move(list);
+                }
+
+                std::atomic_store(&head, snapshot_ptr(std::move(next)));
+        }
+
+        void grow(version& ver, size_t vertices)
+        {
+                if (vertices <= ver.vertices)
+                        return;
+
+                size_t chunks = (vertices + version::chunk_size - 1) >> version::chunk_bits;
+
+                // last chunk is already full of empty lists
+                while (ver.chunks.size() < chunks) {
+                        auto c = std::make_shared<typename version::chunk>();
+                        c->lists.fill(empty);
+                        ver.chunks.push_back(std::move(c));
+                }
+
+                ver.vertices = vertices;
+        }
+
+        std::shared_ptr<const typename graph_version<Edge>::edge_list> empty; /// shared by all vertices without edges
+        snapshot_ptr head; /// accessed only through std::atomic_load and std::atomic_store
+        std::mutex writer;
+};
+
+/**
+ * Build csr from a snapshot of versioned graph.
+ * @param snapshot: version of the graph
+ * @return csr with the same edges order
+ */
+template<typename Edge>
+grlib::csr make_csr(const graph_version<Edge>& snapshot)
+{
+        size_t n = snapshot.vertices_number();
+        grlib::csr graph(n, snapshot.directed);
+
+        for (size_t v = 0; v < n; v++)
+                graph.offsets[v + 1] = graph.offsets[v] + snapshot.edges(v).size();
+
+        graph.targets.resize(graph.offsets[n]);
+        graph.weights.resize(graph.offsets[n]);
+
+        for (size_t v = 0; v < n; v++) {
+                size_t pos = graph.offsets[v];
+
+                for (const auto& edge : snapshot.edges(v)) {
+                        graph.targets[pos] = edge.y;
+                        graph.weights[pos] = edge.weight;
+                        pos++;
+                }
+        }
+
+        return graph;
+}
+
+}; // namespace grlib
@@ -1,6 +1,7 @@
 /** @file */
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -20,13 +21,40 @@ struct Vertices_map {
         void push(const std::string& name)
         {
                 if (max_index == names.size())
-                       names.resize(2 * names.size());
+                       names.resize(std::max<size_t>(2 * names.size(), 1));
 
                 names[max_index] = name;
                 indexes[name] = max_index;
                 max_index++;
         }
 
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        /**
+         * add unique name for vertex created from Graphviz node.
+         * @param name: name of vertex to be added
+         * @param node: Graphviz node of the vertex, see node()
+         */
+        void push(const std::string& name, Agnode_t* node)
+        {
+                push(name);
+
+                if (nodes.size() < names.size())
+                        nodes.resize(names.size(), nullptr);
+
+                nodes[max_index - 1] = node;
+        }
+
+        /**
+         * get Graphviz node of the vertex, without looking its name up.
+         * @param index: index of the vertex
+         * @return node or nullptr if vertex was not created from a node
+         */
+        Agnode_t* node(vertex_id index) const
+        {
+                return static_cast<size_t>(index) < nodes.size() ? nodes[index] : nullptr;
+        }
+#endif
+
         /**
          * get id of the vertex with given index.
          * @param name: name of vertex to be added
@@ -48,6 +76,9 @@ struct Vertices_map {
         std::map<std::string, vertex_id> indexes;
         std::vector<std::string> names;
         size_t max_index;
+#ifdef GRLIB_SYNC_WITH_GRAPHVIZ
+        std::vector<Agnode_t*> nodes; /// Graphviz node of each vertex
+#endif
 };
 
 /**
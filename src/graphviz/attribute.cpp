@@ -0,0 +1,62 @@
+/** @file */
+#include "graphviz/attribute.hpp"
+
+#include <stdexcept>
+
+gviz::Attribute::Attribute()
+: sym(nullptr) { }
+
+gviz::Attribute::Attribute(gviz::cgraph& graph, int obj_type, const std::string& name)
+: sym(agattr(graph.data(), obj_type, const_cast<char*>(name.c_str()), nullptr)) { }
+
+gviz::Attribute::Attribute(gviz::cgraph& graph, int obj_type, const std::string& name,
+                const std::string& default_value)
+: Attribute(graph, obj_type, name)
+{
+        if (!sym)
+                sym = agattr(graph.data(), obj_type, const_cast<char*>(name.c_str()),
+                                const_cast<char*>(default_value.c_str()));
+}
+
+bool gviz::Attribute::operator!() const
+{
+        return !operator bool();
+}
+
+gviz::Attribute::operator bool() const
+{
+        return !!sym;
+}
+
+std::string gviz::Attribute::name() const
+{
+        if (!sym)
+                throw std::runtime_error("gviz::Attribute::name(): invalid attribute");
+
+        return sym->name;
+}
+
+bool gviz::Attribute::set(gviz::Object& object, const std::string& value) const
+{
+        if (!sym)
+                return false;
+
+        int ret = agxset(object.obj, sym, const_cast<char*>(value.c_str()));
+
+        return ret < 0 ? false : true;
+}
+
+std::string gviz::Attribute::get(const gviz::Object& object) const
+{
+        char* str = sym ? agxget(object.obj, sym) : nullptr;
+
+        if (!str)
+                throw std::runtime_error("gviz::Attribute::get(): Cannot get attribute");
+
+        return str;
+}
+
+Agsym_t* gviz::Attribute::data() const
+{
+        return sym;
+}
@@ -0,0 +1,498 @@
+/** @file */
+#include "graphviz/frame_recorder.hpp"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/**
+ * Write the whole buffer to the pipe
+ * @return bool indicating whether all bytes were written
+ */
+bool write_all(int fd, const void* data, size_t size)
+{
+        const char* p = static_cast<const char*>(data);
+
+        while (size > 0) {
+                ssize_t n = write(fd, p, size);
+
+                if (n < 0 and errno == EINTR)
+                        continue;
+                if (n <= 0)
+                        return false;
+
+                p += n;
+                size -= n;
+        }
+
+        return true;
+}
+
+/**
+ * Read exactly size bytes from the pipe
+ * @return bool indicating whether all bytes were read
+ */
+bool read_all(int fd, void* data, size_t size)
+{
+        char* p = static_cast<char*>(data);
+
+        while (size > 0) {
+                ssize_t n = read(fd, p, size);
+
+                if (n < 0 and errno == EINTR)
+                        continue;
+                if (n <= 0)
+                        return false;
+
+                p += n;
+                size -= n;
+        }
+
+        return true;
+}
+
+/**
+ * Hash of attribute value of the object. Hashes of all values are combined with xor,
+ * so they are mixed to keep different sets of values apart.
+ */
+std::uint64_t value_hash(const Agobj_t* obj, const Agsym_t* sym, const std::string& value)
+{
+        std::uint64_t h = std::hash<std::string>()(value);
+        h ^= reinterpret_cast<std::uintptr_t>(obj) * 0x9E3779B97F4A7C15ULL;
+        h ^= reinterpret_cast<std::uintptr_t>(sym) * 0xC2B2AE3D27D4EB4FULL;
+
+        // splitmix64 finalizer
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+
+        return h;
+}
+
+/**
+ * Forked worker processes. Worker gets its index and the write end of its pipe (-1 when
+ * there are no pipes) and exits when work returns. Destructor closes the pipes, so
+ * workers blocked on writing exit, and waits for all of them.
+ */
+class worker_pool {
+    public:
+        worker_pool(unsigned workers, bool piped, const std::function<void(unsigned, int)>& work)
+        {
+                try {
+                        for (unsigned w = 0; w < workers; w++)
+                                start(w, piped, work);
+                } catch (...) {
+                        stop();
+                        throw;
+                }
+        }
+
+        worker_pool(const worker_pool& other) = delete;
+        void operator=(const worker_pool& other) = delete;
+
+        ~worker_pool()
+        {
+                stop();
+        }
+
+        /**
+         * @return read end of worker's pipe
+         */
+        int pipe_of(unsigned worker) const
+        {
+                return pipes[worker];
+        }
+
+        /**
+         * Wait until all workers exit
+         * @return bool indicating whether all of them succeeded
+         */
+        bool wait()
+        {
+                bool success = true;
+
+                for (pid_t pid : pids) {
+                        int status = 0;
+
+                        while (waitpid(pid, &status, 0) < 0)
+                                if (errno != EINTR) {
+                                        status = -1;
+                                        break;
+                                }
+
+                        success = success and WIFEXITED(status) and WEXITSTATUS(status) == 0;
+                }
+
+                pids.clear();
+                return success;
+        }
+
+    private:
+        void start(unsigned worker, bool piped, const std::function<void(unsigned, int)>& work)
+        {
+                int fds[2] = {-1, -1};
+
+                if (piped and pipe(fds) < 0)
+                        throw std::runtime_error{"gviz::render_frames(): cannot create pipe."};
+
+                pid_t pid = fork();
+
+                if (pid < 0) {
+                        if (piped) {
+                                close(fds[0]);
+                                close(fds[1]);
+                        }
+
+                        throw std::runtime_error{"gviz::render_frames(): cannot start worker process."};
+                }
+
+                if (pid == 0) {
+                        // pipes of other workers are read by the parent only
+                        for (int fd : pipes)
+                                close(fd);
+                        if (piped)
+                                close(fds[0]);
+
+                        int status = 0;
+
+                        try {
+                                work(worker, fds[1]);
+                        } catch (...) {
+                                status = 1;
+                        }
+
+                        // skip destructors and stdio buffers, they belong to the parent
+                        _exit(status);
+                }
+
+                pids.push_back(pid);
+
+                if (piped) {
+                        close(fds[1]);
+                        pipes.push_back(fds[0]);
+                }
+        }
+
+        void stop()
+        {
+                for (int fd : pipes)
+                        close(fd);
+
+                pipes.clear();
+                wait();
+        }
+
+        std::vector<pid_t> pids;
+        std::vector<int> pipes; /// read ends of workers' pipes
+};
+
+}; // namespace
+
+bool gviz::frame_recorder::set_attr(gviz::Object& object, const std::string& attr,
+                const std::string& value)
+{
+        Agobj_t* obj = object.obj;
+        Agsym_t* sym = agattr(agraphof(obj), AGTYPE(obj), const_cast<char*>(attr.c_str()), nullptr);
+
+        return sym ? record(obj, sym, value) : false;
+}
+
+bool gviz::frame_recorder::set_attr_safe(gviz::Object& object, const std::string& attr,
+                const std::string& value, const std::string& default_value)
+{
+        Agobj_t* obj = object.obj;
+        Agraph_t* g = agraphof(obj);
+        char* name = const_cast<char*>(attr.c_str());
+
+        Agsym_t* sym = agattr(g, AGTYPE(obj), name, nullptr);
+
+        // declaring the attribute is not recorded, the default value shows in every frame
+        if (!sym)
+                sym = agattr(g, AGTYPE(obj), name, const_cast<char*>(default_value.c_str()));
+
+        return sym ? record(obj, sym, value) : false;
+}
+
+bool gviz::frame_recorder::set_attr(gviz::Object& object, const gviz::Attribute& attribute,
+                const std::string& value)
+{
+        return attribute ? record(object.obj, attribute.data(), value) : false;
+}
+
+bool gviz::frame_recorder::frame()
+{
+        if (!frames.empty() and same_as_last_frame())
+                return false;
+
+        frames.push_back(changes.size());
+        last_frame_hash = hash;
+
+        return true;
+}
+
+void gviz::frame_recorder::sample(size_t every)
+{
+        if (every <= 1 or frames.empty())
+                return;
+
+        std::vector<size_t> kept;
+
+        for (size_t i = 0; i < frames.size(); i += every)
+                kept.push_back(frames[i]);
+
+        if ((frames.size() - 1) % every != 0)
+                kept.push_back(frames.back());
+
+        frames = std::move(kept);
+}
+
+void gviz::frame_recorder::limit(size_t max_frames)
+{
+        size_t n = frames.size();
+
+        if (n <= max_frames)
+                return;
+
+        std::vector<size_t> kept;
+
+        if (max_frames == 1)
+                kept.push_back(frames.back());
+
+        // n > max_frames, so the indexes are increasing
+        for (size_t i = 0; max_frames > 1 and i < max_frames; i++)
+                kept.push_back(frames[i * (n - 1) / (max_frames - 1)]);
+
+        frames = std::move(kept);
+}
+
+size_t gviz::frame_recorder::frames_number() const
+{
+        return frames.size();
+}
+
+std::uint64_t gviz::frame_recorder::state_hash() const
+{
+        return hash;
+}
+
+void gviz::frame_recorder::seek(size_t frame)
+{
+        if (frame >= frames.size())
+                throw std::runtime_error{"gviz::frame_recorder::seek(): no frame: " + std::to_string(frame)};
+
+        move_to(frames[frame]);
+}
+
+void gviz::frame_recorder::seek_end()
+{
+        move_to(changes.size());
+}
+
+bool gviz::frame_recorder::record(Agobj_t* obj, Agsym_t* sym, const std::string& value)
+{
+        seek_end();
+
+        std::string old_value = agxget(obj, sym);
+
+        if (old_value == value)
+                return true;
+
+        if (agxset(obj, sym, const_cast<char*>(value.c_str())) < 0)
+                return false;
+
+        hash ^= value_hash(obj, sym, old_value) ^ value_hash(obj, sym, value);
+        changes.push_back({obj, sym, std::move(old_value), value});
+        position = changes.size();
+
+        return true;
+}
+
+bool gviz::frame_recorder::same_as_last_frame() const
+{
+        if (hash != last_frame_hash)
+                return false;
+
+        // equal hashes are verified: each attribute changed since the frame has its value back
+        std::map<std::pair<Agobj_t*, Agsym_t*>, std::pair<const std::string*, const std::string*>> values;
+
+        for (size_t i = frames.back(); i < changes.size(); i++) {
+                const attribute_change& change = changes[i];
+                auto it = values.emplace(std::make_pair(change.obj, change.sym),
+                                std::make_pair(&change.old_value, &change.new_value)).first;
+
+                it->second.second = &change.new_value;
+        }
+
+        for (const auto& value : values)
+                if (*value.second.first != *value.second.second)
+                        return false;
+
+        return true;
+}
+
+void gviz::frame_recorder::move_to(size_t target)
+{
+        for (; position < target; position++) {
+                const attribute_change& change = changes[position];
+                agxset(change.obj, change.sym, const_cast<char*>(change.new_value.c_str()));
+        }
+
+        for (; position > target; position--) {
+                const attribute_change& change = changes[position - 1];
+                agxset(change.obj, change.sym, const_cast<char*>(change.old_value.c_str()));
+        }
+}
+
+std::vector<size_t> gviz::render_frames(gviz::graphviz_context& context, gviz::cgraph& graph,
+                gviz::frame_recorder& recorder, const std::string& extension, unsigned workers)
+{
+        size_t frames = recorder.frames_number();
+        workers = std::min<size_t>(std::max(workers, 1u), std::max<size_t>(frames, 1));
+
+        std::vector<size_t> failed;
+
+        auto render_frame = [&] (size_t frame) {
+                try {
+                        recorder.seek(frame);
+                        gviz::render(context, graph, std::to_string(frame), extension);
+                } catch (std::exception&) {
+                        return false;
+                }
+
+                return true;
+        };
+
+        if (workers == 1) {
+                for (size_t frame = 0; frame < frames; frame++)
+                        if (!render_frame(frame))
+                                failed.push_back(frame);
+
+                recorder.seek_end();
+                return failed;
+        }
+
+        // workers change their copies of the graph, this one stays in the final state
+        recorder.seek_end();
+
+        // a byte per frame tells whether it was rendered
+        worker_pool pool(workers, true, [&] (unsigned worker, int fd) {
+                for (size_t frame = worker; frame < frames; frame += workers) {
+                        char rendered = render_frame(frame);
+
+                        if (!write_all(fd, &rendered, sizeof(rendered)))
+                                throw std::runtime_error{"gviz::render_frames(): cannot send frame."};
+                }
+        });
+
+        for (size_t frame = 0; frame < frames; frame++) {
+                char rendered = 0;
+
+                if (!read_all(pool.pipe_of(frame % workers), &rendered, sizeof(rendered)))
+                        throw std::runtime_error{"gviz::render_frames(): rendering frame "
+                                + std::to_string(frame) + " failed."};
+
+                if (!rendered)
+                        failed.push_back(frame);
+        }
+
+        if (!pool.wait())
+                throw std::runtime_error{"gviz::render_frames(): rendering frames failed."};
+
+        return failed;
+}
+
+std::vector<size_t> gviz::render_frames(gviz::graphviz_context& context, gviz::cgraph& graph,
+                gviz::frame_recorder& recorder, gviz::gif_animation& animation, unsigned workers)
+{
+        size_t frames = recorder.frames_number();
+        workers = std::min<size_t>(std::max(workers, 1u), std::max<size_t>(frames, 1));
+
+        // size sent instead of a frame which was not rendered
+        const std::uint64_t no_frame = ~std::uint64_t(0);
+
+        std::vector<size_t> failed;
+        std::vector<char> buffer;
+
+        auto render_frame = [&] (size_t frame) {
+                try {
+                        recorder.seek(frame);
+                        gviz::render_to_memory(context, graph, "gd", buffer);
+                } catch (std::exception&) {
+                        return false;
+                }
+
+                return true;
+        };
+
+        auto add_frame = [&] (size_t frame) {
+                try {
+                        animation.add_gd_frame(buffer);
+                } catch (std::exception&) {
+                        failed.push_back(frame);
+                }
+        };
+
+        if (workers == 1) {
+                for (size_t frame = 0; frame < frames; frame++)
+                        if (render_frame(frame))
+                                add_frame(frame);
+                        else
+                                failed.push_back(frame);
+
+                recorder.seek_end();
+                return failed;
+        }
+
+        // workers change their copies of the graph, this one stays in the final state
+        recorder.seek_end();
+
+        // a frame is sent as its size and data, the pipe holds workers back until it is read
+        worker_pool pool(workers, true, [&] (unsigned worker, int fd) {
+                for (size_t frame = worker; frame < frames; frame += workers) {
+                        std::uint64_t size = render_frame(frame) ? buffer.size() : no_frame;
+
+                        if (!write_all(fd, &size, sizeof(size))
+                                        or (size != no_frame and !write_all(fd, buffer.data(), size)))
+                                throw std::runtime_error{"gviz::render_frames(): cannot send frame."};
+                }
+        });
+
+        for (size_t frame = 0; frame < frames; frame++) {
+                int fd = pool.pipe_of(frame % workers);
+                std::uint64_t size = 0;
+
+                if (!read_all(fd, &size, sizeof(size)))
+                        throw std::runtime_error{"gviz::render_frames(): rendering frame "
+                                + std::to_string(frame) + " failed."};
+
+                if (size == no_frame) {
+                        failed.push_back(frame);
+                        continue;
+                }
+
+                buffer.resize(size);
+
+                if (!read_all(fd, buffer.data(), size))
+                        throw std::runtime_error{"gviz::render_frames(): rendering frame "
+                                + std::to_string(frame) + " failed."};
+
+                add_frame(frame);
+        }
+
+        if (!pool.wait())
+                throw std::runtime_error{"gviz::render_frames(): rendering frames failed."};
+
+        return failed;
+}
@@ -0,0 +1,476 @@
+/** @file */
+#include "graphviz/gif.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+constexpr unsigned max_gif_delay = 65535;
+
+/**
+ * Append 16-bit little endian value
+ */
+void put_word(std::vector<std::uint8_t>& out, unsigned value)
+{
+        out.push_back(value & 0xFF);
+        out.push_back((value >> 8) & 0xFF);
+}
+
+/**
+ * Variable length codes packed LSB first into data sub-blocks of at most 255 bytes
+ */
+class code_writer {
+    public:
+        code_writer(std::vector<std::uint8_t>& out)
+        : out(out), bits(0), count(0), block_start(out.size())
+        {
+                out.push_back(0);
+        }
+
+        void write(unsigned code, unsigned size)
+        {
+                bits |= static_cast<std::uint32_t>(code) << count;
+                count += size;
+
+                while (count >= 8) {
+                        put(bits & 0xFF);
+                        bits >>= 8;
+                        count -= 8;
+                }
+        }
+
+        void finish()
+        {
+                if (count > 0)
+                        put(bits & 0xFF);
+
+                if (out.size() - block_start > 1)
+                        out[block_start] = out.size() - block_start - 1;
+                else
+                        out.pop_back();
+
+                // block terminator
+                out.push_back(0);
+        }
+
+    private:
+        void put(std::uint8_t byte)
+        {
+                out.push_back(byte);
+
+                if (out.size() - block_start == 256) {
+                        out[block_start] = 255;
+                        block_start = out.size();
+                        out.push_back(0);
+                }
+        }
+
+        std::vector<std::uint8_t>& out;
+        std::uint32_t bits;
+        unsigned count;
+        size_t block_start; /// position of the size byte of the current sub-block
+};
+
+/**
+ * GIF flavour of LZW: codes grow from min_code_size + 1 up to 12 bits, the dictionary
+ * is cleared when full. Dictionary is an open addressing hash of (prefix, index) pairs.
+ */
+void lzw_encode(const std::vector<std::uint8_t>& indexes, unsigned min_code_size,
+                std::vector<std::uint8_t>& out)
+{
+        constexpr size_t table_size = 5003; /// prime, about 20% bigger than 4096 codes
+        constexpr unsigned max_code = 4095;
+
+        const unsigned clear = 1U << min_code_size;
+        const unsigned end = clear + 1;
+
+        std::vector<std::int32_t> keys(table_size, -1);
+        std::vector<std::uint16_t> codes(table_size);
+
+        unsigned code_size = min_code_size + 1;
+        unsigned last = end; /// last assigned code
+
+        out.push_back(min_code_size);
+        code_writer writer(out);
+        writer.write(clear, code_size);
+
+        unsigned prefix = indexes[0];
+
+        for (size_t i = 1; i < indexes.size(); i++) {
+                unsigned k = indexes[i];
+                std::int32_t key = (k << 12) | prefix;
+                size_t h = ((k << 4) ^ prefix) % table_size;
+
+                while (keys[h] != -1 and keys[h] != key)
+                        h = h + 1 == table_size ? 0 : h + 1;
+
+                if (keys[h] == key) {
+                        prefix = codes[h];
+                        continue;
+                }
+
+                writer.write(prefix, code_size);
+
+                keys[h] = key;
+                codes[h] = ++last;
+
+                // decoder lags one code behind, so it switches size at the same code
+                if (last >= (1U << code_size))
+                        code_size++;
+
+                if (last == max_code) {
+                        writer.write(clear, code_size);
+                        std::fill(keys.begin(), keys.end(), -1);
+                        code_size = min_code_size + 1;
+                        last = end;
+                }
+
+                prefix = k;
+        }
+
+        writer.write(prefix, code_size);
+        writer.write(end, code_size);
+        writer.finish();
+}
+
+/**
+ * @return color blended with white according to gd alpha (0 opaque, 127 transparent)
+ */
+std::uint32_t blend_white(std::uint32_t color, unsigned alpha)
+{
+        if (alpha == 0)
+                return color & 0xFFFFFF;
+
+        alpha = std::min(alpha, 127U);
+        std::uint32_t result = 0;
+
+        for (int shift = 0; shift <= 16; shift += 8) {
+                unsigned c = (color >> shift) & 0xFF;
+                c = (c * (127 - alpha) + 255 * alpha) / 127;
+                result |= c << shift;
+        }
+
+        return result;
+}
+
+}; // namespace
+
+void gviz::decode_gd(const std::vector<char>& data, gviz::rgb_image& image)
+{
+        auto byte = [&] (size_t pos) -> std::uint32_t {
+                return static_cast<std::uint8_t>(data[pos]);
+        };
+
+        auto word = [&] (size_t pos) { return byte(pos) << 8 | byte(pos + 1); };
+
+        auto dword = [&] (size_t pos) {
+                return byte(pos) << 24 | byte(pos + 1) << 16 | byte(pos + 2) << 8 | byte(pos + 3);
+        };
+
+        if (data.size() < 7)
+                throw std::runtime_error{"gviz::decode_gd(): truncated image."};
+
+        unsigned signature = word(0);
+        if (signature != 0xFFFE and signature != 0xFFFF)
+                throw std::runtime_error{"gviz::decode_gd(): not a gd 2.x image."};
+
+        image.width = word(2);
+        image.height = word(4);
+        bool truecolor = byte(6);
+
+        size_t n = image.width * image.height;
+        image.pixels.resize(n);
+
+        if (truecolor) {
+                constexpr size_t header = 11;
+
+                if (data.size() < header + 4 * n)
+                        throw std::runtime_error{"gviz::decode_gd(): truncated image."};
+
+                std::uint32_t transparent = dword(7);
+
+                for (size_t i = 0; i < n; i++) {
+                        std::uint32_t pixel = dword(header + 4 * i);
+
+                        image.pixels[i] = pixel == transparent ? 0xFFFFFF
+                                : blend_white(pixel, (pixel >> 24) & 0x7F);
+                }
+
+                return;
+        }
+
+        constexpr size_t palette = 13;
+        constexpr size_t header = palette + 256 * 4;
+
+        if (data.size() < header + n)
+                throw std::runtime_error{"gviz::decode_gd(): truncated image."};
+
+        std::int32_t transparent = static_cast<std::int32_t>(dword(9));
+        std::uint32_t colors[256];
+
+        for (size_t i = 0; i < 256; i++) {
+                size_t pos = palette + 4 * i;
+                std::uint32_t rgb = byte(pos) << 16 | byte(pos + 1) << 8 | byte(pos + 2);
+
+                colors[i] = static_cast<std::int32_t>(i) == transparent ? 0xFFFFFF
+                        : blend_white(rgb, byte(pos + 3));
+        }
+
+        for (size_t i = 0; i < n; i++)
+                image.pixels[i] = colors[byte(header + i)];
+}
+
+gviz::gif_animation::gif_animation(const std::string& file_name, unsigned delay, unsigned loops)
+: file(fopen(file_name.c_str(), "wb")),
+  delay(std::min(delay, max_gif_delay)),
+  loops(std::min(loops, max_gif_delay)),
+  frames(0),
+  pending_delay(0),
+  pending_delay_pos(0)
+{
+        if (!file)
+                throw std::runtime_error{"gviz::gif_animation(): cannot open: " + file_name + " file."};
+}
+
+gviz::gif_animation::~gif_animation()
+{
+        try {
+                close();
+        } catch (std::exception&) {
+        }
+}
+
+void gviz::gif_animation::add_gd_frame(const std::vector<char>& data)
+{
+        gviz::decode_gd(data, current);
+        add_frame(current);
+}
+
+void gviz::gif_animation::add_frame(const gviz::rgb_image& frame)
+{
+        if (!file)
+                throw std::runtime_error{"gviz::gif_animation::add_frame(): animation is closed."};
+
+        if (frame.width == 0 or frame.height == 0 or frame.width > 0xFFFF or frame.height > 0xFFFF)
+                throw std::runtime_error{"gviz::gif_animation::add_frame(): invalid frame size."};
+
+        if (frames == 0) {
+                std::vector<std::uint8_t> header = {'G', 'I', 'F', '8', '9', 'a'};
+                put_word(header, frame.width);
+                put_word(header, frame.height);
+
+                // no global color table, every frame has its own
+                header.insert(header.end(), {0, 0, 0});
+
+                // application extension with the number of loops
+                header.insert(header.end(), {0x21, 0xFF, 0x0B});
+                header.insert(header.end(), {'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0'});
+                header.insert(header.end(), {0x03, 0x01});
+                put_word(header, loops);
+                header.push_back(0);
+
+                fwrite(header.data(), 1, header.size(), file);
+
+                previous = frame;
+                frames++;
+                encode(frame, false, 0, 0, frame.width, frame.height);
+                return;
+        }
+
+        if (frame.width != previous.width or frame.height != previous.height)
+                throw std::runtime_error{"gviz::gif_animation::add_frame(): frame size differs."};
+
+        frames++;
+
+        // bounding rectangle of changed pixels
+        size_t w = frame.width, h = frame.height;
+        size_t top = h, bottom = 0, left = w, right = 0;
+
+        for (size_t y = 0; y < h; y++) {
+                const std::uint32_t* a = &frame.pixels[y * w];
+                const std::uint32_t* b = &previous.pixels[y * w];
+
+                if (std::memcmp(a, b, w * sizeof(std::uint32_t)) == 0)
+                        continue;
+
+                size_t first = 0, last = w - 1;
+                while (a[first] == b[first])
+                        first++;
+                while (a[last] == b[last])
+                        last--;
+
+                top = std::min(top, y);
+                bottom = y;
+                left = std::min(left, first);
+                right = std::max(right, last);
+        }
+
+        if (top == h) {
+                pending_delay = std::min(pending_delay + delay, max_gif_delay);
+                return;
+        }
+
+        write_pending();
+        encode(frame, true, left, top, right - left + 1, bottom - top + 1);
+
+        for (size_t y = top; y <= bottom; y++)
+                std::copy(&frame.pixels[y * w + left], &frame.pixels[y * w + right] + 1,
+                                &previous.pixels[y * w + left]);
+}
+
+void gviz::gif_animation::encode(const gviz::rgb_image& frame, bool delta, size_t left, size_t top,
+                size_t width, size_t height)
+{
+        size_t w = frame.width;
+
+        auto changed = [&] (size_t x, size_t y) {
+                return !delta or frame.pixels[y * w + x] != previous.pixels[y * w + x];
+        };
+
+        std::unordered_map<std::uint32_t, size_t> counts;
+        bool transparent = false;
+
+        for (size_t y = top; y < top + height; y++)
+                for (size_t x = left; x < left + width; x++) {
+                        if (changed(x, y))
+                                counts[frame.pixels[y * w + x]]++;
+                        else
+                                transparent = true;
+                }
+
+        // the most frequent colors, ties in order of color to keep output deterministic
+        std::vector<std::pair<size_t, std::uint32_t>> by_count;
+        by_count.reserve(counts.size());
+        for (const auto& c : counts)
+                by_count.emplace_back(c.second, c.first);
+
+        std::sort(by_count.begin(), by_count.end(), [] (const auto& a, const auto& b) {
+                return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+
+        size_t limit = transparent ? 255 : 256;
+        std::vector<std::uint32_t> palette;
+        std::unordered_map<std::uint32_t, std::uint8_t> index;
+
+        for (size_t i = 0; i < std::min(limit, by_count.size()); i++) {
+                index[by_count[i].second] = palette.size();
+                palette.push_back(by_count[i].second);
+        }
+
+        // remaining colors are mapped to the nearest palette entry
+        for (size_t i = limit; i < by_count.size(); i++) {
+                std::uint32_t color = by_count[i].second;
+                long best = -1;
+                size_t best_index = 0;
+
+                for (size_t j = 0; j < palette.size(); j++) {
+                        long distance = 0;
+                        for (int shift = 0; shift <= 16; shift += 8) {
+                                long d = static_cast<long>((color >> shift) & 0xFF)
+                                        - static_cast<long>((palette[j] >> shift) & 0xFF);
+                                distance += d * d;
+                        }
+
+                        if (best < 0 or distance < best) {
+                                best = distance;
+                                best_index = j;
+                        }
+                }
+
+                index[color] = best_index;
+        }
+
+        std::uint8_t transparent_index = palette.size();
+        size_t entries = palette.size() + (transparent ? 1 : 0);
+
+        unsigned bits = 1;
+        while ((1U << bits) < entries)
+                bits++;
+
+        std::vector<std::uint8_t> indexes;
+        indexes.reserve(width * height);
+
+        for (size_t y = top; y < top + height; y++)
+                for (size_t x = left; x < left + width; x++)
+                        indexes.push_back(changed(x, y) ? index[frame.pixels[y * w + x]] : transparent_index);
+
+        pending.clear();
+
+        // graphic control extension: keep previous frame under this one, delay, transparency
+        pending.insert(pending.end(), {0x21, 0xF9, 0x04});
+        pending.push_back(1 << 2 | (transparent ? 1 : 0));
+        pending_delay_pos = pending.size();
+        put_word(pending, 0);
+        pending.push_back(transparent ? transparent_index : 0);
+        pending.push_back(0);
+        pending_delay = delay;
+
+        // image descriptor with local color table
+        pending.push_back(0x2C);
+        put_word(pending, left);
+        put_word(pending, top);
+        put_word(pending, width);
+        put_word(pending, height);
+        pending.push_back(0x80 | (bits - 1));
+
+        for (size_t i = 0; i < (1U << bits); i++) {
+                std::uint32_t color = i < palette.size() ? palette[i] : 0;
+                pending.push_back((color >> 16) & 0xFF);
+                pending.push_back((color >> 8) & 0xFF);
+                pending.push_back(color & 0xFF);
+        }
+
+        lzw_encode(indexes, std::max(2U, bits), pending);
+}
+
+void gviz::gif_animation::write_pending()
+{
+        if (pending.empty())
+                return;
+
+        pending[pending_delay_pos] = pending_delay & 0xFF;
+        pending[pending_delay_pos + 1] = (pending_delay >> 8) & 0xFF;
+
+        fwrite(pending.data(), 1, pending.size(), file);
+        pending.clear();
+}
+
+void gviz::gif_animation::close()
+{
+        if (!file)
+                return;
+
+        // GIF needs at least one image
+        if (frames == 0) {
+                gviz::rgb_image blank;
+                blank.width = blank.height = 1;
+                blank.pixels.assign(1, 0xFFFFFF);
+                add_frame(blank);
+        }
+
+        write_pending();
+        fputc(0x3B, file);
+
+        bool failed = ferror(file);
+        fclose(file);
+        file = nullptr;
+
+        if (failed)
+                throw std::runtime_error{"gviz::gif_animation::close(): write error."};
+}
+
+size_t gviz::gif_animation::frames_number() const
+{
+        return frames;
+}
+
+void gviz::render(gviz::graphviz_context& context, gviz::cgraph& graph,
+                gviz::gif_animation& animation)
+{
+        gviz::render_to_memory(context, graph, "gd", animation.render_buffer);
+        animation.add_gd_frame(animation.render_buffer);
+}
@@ -19,6 +19,11 @@ void gviz::graphviz_context::set_layout(cgraph& graph, const std::string& layout
         gvLayout(gvc, graph.data(), const_cast<char*>(layout.c_str()));
 }
 
+void gviz::graphviz_context::free_layout(cgraph& graph)
+{
+        gvFreeLayout(gvc, graph.data());
+}
+
 GVC_t* gviz::graphviz_context::data()
 {
         return gvc;
@@ -45,3 +50,31 @@ void gviz::render(gviz::graphviz_context& context, gviz::cgraph& graph, const st
         gvRender(context.data(), graph.data(), extension.c_str(), f);
         fclose(f);
 }
+
+size_t gviz::render_to_memory(gviz::graphviz_context& context, gviz::cgraph& graph,
+                const std::string& format, std::vector<char>& buffer)
+{
+        char* data = nullptr;
+        unsigned int length = 0;
+
+        if (gvRenderData(context.data(), graph.data(), format.c_str(), &data, &length) != 0) {
+                if (data)
+                        gvFreeRenderData(data);
+
+                throw std::runtime_error{"gviz::render_to_memory(): cannot render " + format + " data."};
+        }
+
+        // Graphviz allocates its own buffer for every call, keep ours to spare reallocations
+        buffer.assign(data, data + length);
+        gvFreeRenderData(data);
+
+        return length;
+}
+
+std::vector<char> gviz::render_to_memory(gviz::graphviz_context& context, gviz::cgraph& graph,
+                const std::string& format)
+{
+        std::vector<char> buffer;
+        render_to_memory(context, graph, format, buffer);
+        return buffer;
+}
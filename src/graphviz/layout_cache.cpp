@@ -0,0 +1,235 @@
+/** @file */
+#include "graphviz/layout_cache.hpp"
+
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t fnv_offset = 14695981039346656037ULL;
+constexpr std::uint64_t fnv_prime = 1099511628211ULL;
+
+/// attributes computed by layouts, restored from the cache
+const std::vector<std::string> graph_attrs = {"bb", "lp"};
+const std::vector<std::string> node_attrs = {"pos"};
+const std::vector<std::string> edge_attrs = {"pos", "lp"};
+
+using attribute_list = std::vector<std::pair<std::string, std::string>>;
+
+std::uint64_t fnv1a(std::uint64_t hash, const char* data, size_t size)
+{
+        for (size_t i = 0; i < size; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= fnv_prime;
+        }
+
+        return hash;
+}
+
+std::string cache_file(const std::string& cache_dir, std::uint64_t hash)
+{
+        char name[32];
+        snprintf(name, sizeof(name), "%016" PRIx64 ".layout", hash);
+
+        return cache_dir + "/" + name;
+}
+
+std::string header(std::uint64_t hash, Agraph_t* g)
+{
+        char line[64];
+        snprintf(line, sizeof(line), "gviz-layout %016" PRIx64 " %d %d", hash, agnnodes(g), agnedges(g));
+
+        return line;
+}
+
+/**
+ * Append line with the kind of the object and its attributes separated by tabs
+ * @return bool indicating whether values can be stored in a line
+ */
+bool write_object(std::string& out, char kind, void* obj, const std::vector<std::string>& attrs)
+{
+        out += kind;
+
+        for (const auto& attr : attrs) {
+                char* value = agget(obj, const_cast<char*>(attr.c_str()));
+
+                if (!value or !*value)
+                        continue;
+
+                std::string v = value;
+
+                if (v.find_first_of("\t\n") != std::string::npos)
+                        return false;
+
+                out += '\t' + attr + '\t' + v;
+        }
+
+        out += '\n';
+        return true;
+}
+
+/**
+ * Parse line written by write_object()
+ * @return bool indicating whether the line is valid and describes the kind of object
+ */
+bool read_object(const std::string& line, char kind, attribute_list& attrs)
+{
+        if (line.empty() or line[0] != kind)
+                return false;
+
+        std::vector<std::string> fields;
+        size_t start = 1;
+
+        while (start < line.size()) {
+                if (line[start] != '\t')
+                        return false;
+
+                size_t end = line.find('\t', start + 1);
+                if (end == std::string::npos)
+                        end = line.size();
+
+                fields.emplace_back(line.substr(start + 1, end - start - 1));
+                start = end;
+        }
+
+        if (fields.size() % 2)
+                return false;
+
+        for (size_t i = 0; i < fields.size(); i += 2)
+                attrs.emplace_back(fields[i], fields[i + 1]);
+
+        return true;
+}
+
+void apply(void* obj, const attribute_list& attrs)
+{
+        for (const auto& attr : attrs)
+                agsafeset(obj, const_cast<char*>(attr.first.c_str()),
+                                const_cast<char*>(attr.second.c_str()), const_cast<char*>(""));
+}
+
+/**
+ * Set positions stored in the cache file, the graph is not changed when file is missing
+ * or does not match it
+ */
+bool load_positions(Agraph_t* g, const std::string& file_name, std::uint64_t hash)
+{
+        std::ifstream file(file_name);
+        std::string line;
+
+        if (!file or !std::getline(file, line) or line != header(hash, g))
+                return false;
+
+        // graph, then nodes and their out edges in the order cgraph iterates them
+        std::vector<attribute_list> objects(1 + agnnodes(g) + agnedges(g));
+        size_t index = 0;
+
+        auto read = [&] (char kind) {
+                return std::getline(file, line) and read_object(line, kind, objects[index++]);
+        };
+
+        if (!read('g'))
+                return false;
+
+        for (Agnode_t* n = agfstnode(g); n; n = agnxtnode(g, n))
+                if (!read('n'))
+                        return false;
+
+        for (Agnode_t* n = agfstnode(g); n; n = agnxtnode(g, n))
+                for (Agedge_t* e = agfstout(g, n); e; e = agnxtout(g, e))
+                        if (!read('e'))
+                                return false;
+
+        index = 0;
+        apply(g, objects[index++]);
+
+        for (Agnode_t* n = agfstnode(g); n; n = agnxtnode(g, n))
+                apply(n, objects[index++]);
+
+        for (Agnode_t* n = agfstnode(g); n; n = agnxtnode(g, n))
+                for (Agedge_t* e = agfstout(g, n); e; e = agnxtout(g, e))
+                        apply(e, objects[index++]);
+
+        return true;
+}
+
+/**
+ * Write positions of laid out graph, see load_positions()
+ */
+void save_positions(Agraph_t* g, const std::string& file_name, std::uint64_t hash)
+{
+        std::string out = header(hash, g) + '\n';
+        bool valid = write_object(out, 'g', g, graph_attrs);
+
+        for (Agnode_t* n = agfstnode(g); n and valid; n = agnxtnode(g, n))
+                valid = write_object(out, 'n', n, node_attrs);
+
+        for (Agnode_t* n = agfstnode(g); n and valid; n = agnxtnode(g, n))
+                for (Agedge_t* e = agfstout(g, n); e and valid; e = agnxtout(g, e))
+                        valid = write_object(out, 'e', e, edge_attrs);
+
+        if (!valid)
+                return;
+
+        // other programs may read the cache meanwhile, so it is replaced at once
+        std::string tmp_name = file_name + "." + std::to_string(getpid());
+        std::ofstream file(tmp_name);
+        file.write(out.data(), out.size());
+        file.close();
+
+        if (file)
+                std::rename(tmp_name.c_str(), file_name.c_str());
+        else
+                std::remove(tmp_name.c_str());
+}
+
+}; // namespace
+
+std::uint64_t gviz::layout_hash(gviz::cgraph& graph, const std::string& layout)
+{
+        FILE* f = tmpfile();
+
+        if (!f)
+                throw std::runtime_error{"gviz::layout_hash(): cannot create temporary file."};
+
+        agwrite(graph.data(), f);
+        rewind(f);
+
+        std::uint64_t hash = fnv_offset;
+        char buffer[64 * 1024];
+        size_t n;
+
+        while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+                hash = fnv1a(hash, buffer, n);
+
+        fclose(f);
+
+        return fnv1a(hash, layout.c_str(), layout.size() + 1);
+}
+
+bool gviz::set_cached_layout(gviz::graphviz_context& context, gviz::cgraph& graph,
+                const std::string& layout, const std::string& cache_dir)
+{
+        std::uint64_t hash = layout_hash(graph, layout);
+        std::string file_name = cache_file(cache_dir, hash);
+
+        if (load_positions(graph.data(), file_name, hash)) {
+                context.set_layout(graph, "nop2");
+                return true;
+        }
+
+        if (gvLayout(context.data(), graph.data(), layout.c_str()) != 0)
+                throw std::runtime_error{"gviz::set_cached_layout(): layout " + layout + " failed."};
+
+        // positions are stored in attributes only while rendering to dot format
+        gviz::render_to_memory(context, graph, "dot");
+        save_positions(graph.data(), file_name, hash);
+
+        return false;
+}
@@ -0,0 +1,191 @@
+/** @file */
+#include "graphviz/overview.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+gviz::graph_type type_of(Agraph_t* g, bool strict)
+{
+        if (agisdirected(g))
+                return strict ? gviz::graph_type::strict_directed : gviz::graph_type::directed;
+
+        return strict ? gviz::graph_type::strict_undirected : gviz::graph_type::undirected;
+}
+
+Agsym_t* declare(Agraph_t* g, int kind, const char* attr, const std::string& default_value)
+{
+        return agattr(g, kind, const_cast<char*>(attr), const_cast<char*>(default_value.c_str()));
+}
+
+void set(void* obj, Agsym_t* sym, const std::string& value)
+{
+        agxset(obj, sym, const_cast<char*>(value.c_str()));
+}
+
+}; // namespace
+
+bool gviz::set_large_graph_attrs(gviz::cgraph& graph)
+{
+        // sfdp is multilevel by default; quadtree makes each level O(n log n)
+        return graph.def_graph_attr("quadtree", "fast")
+                and graph.def_graph_attr("overlap", "prism")
+                and graph.def_graph_attr("splines", "false")
+                and graph.def_graph_attr("outputorder", "edgesfirst");
+}
+
+gviz::cgraph gviz::quotient_graph(gviz::cgraph& graph, const std::vector<Agnode_t*>& nodes,
+                const std::vector<int>& labels, size_t max_nodes)
+{
+        Agraph_t* g = graph.data();
+        size_t n = std::min(nodes.size(), labels.size());
+
+        std::vector<size_t> members;
+
+        for (size_t v = 0; v < n; v++) {
+                if (!nodes[v] or labels[v] < 1)
+                        continue;
+
+                if (static_cast<size_t>(labels[v]) >= members.size())
+                        members.resize(labels[v] + 1, 0);
+
+                members[labels[v]]++;
+        }
+
+        std::vector<int> kept;
+
+        for (size_t label = 1; label < members.size(); label++)
+                if (members[label] > 0)
+                        kept.push_back(label);
+
+        bool merged = max_nodes > 0 and kept.size() > max_nodes;
+
+        if (merged) {
+                // the largest groups, equal ones in order of labels
+                std::stable_sort(kept.begin(), kept.end(),
+                                [&] (int a, int b) { return members[a] > members[b]; });
+                kept.resize(max_nodes - 1);
+                std::sort(kept.begin(), kept.end());
+        }
+
+        int other = kept.size();
+        std::vector<int> group_of_label(members.size(), merged ? other : -1);
+        std::vector<size_t> group_members(kept.size() + merged, 0);
+
+        for (size_t i = 0; i < kept.size(); i++)
+                group_of_label[kept[i]] = i;
+
+        for (size_t label = 1; label < members.size(); label++)
+                if (group_of_label[label] >= 0)
+                        group_members[group_of_label[label]] += members[label];
+
+        cgraph overview(std::string(agnameof(g)) + "_overview", type_of(g, true));
+        Agraph_t* q = overview.data();
+
+        declare(q, AGNODE, "shape", "circle");
+        declare(q, AGNODE, "fixedsize", "true");
+        declare(q, AGNODE, "style", "filled");
+
+        Agsym_t* label_sym = declare(q, AGNODE, "label", "\\N");
+        Agsym_t* members_sym = declare(q, AGNODE, "members", "0");
+        Agsym_t* width_sym = declare(q, AGNODE, "width", "0.75");
+        Agsym_t* height_sym = declare(q, AGNODE, "height", "0.5");
+        Agsym_t* weight_sym = declare(q, AGEDGE, "weight", "1");
+        Agsym_t* penwidth_sym = declare(q, AGEDGE, "penwidth", "1");
+
+        std::vector<Agnode_t*> super_nodes;
+
+        for (size_t i = 0; i < group_members.size(); i++) {
+                std::string name = i < kept.size() ? std::to_string(kept[i]) : "other";
+                Agnode_t* node = agnode(q, const_cast<char*>(name.c_str()), 1);
+
+                // size grows slowly, so a giant group does not cover the others
+                std::string size = std::to_string(0.5 + 0.25 * std::log2(group_members[i]));
+
+                set(node, label_sym, name + "\\n" + std::to_string(group_members[i]));
+                set(node, members_sym, std::to_string(group_members[i]));
+                set(node, width_sym, size);
+                set(node, height_sym, size);
+
+                super_nodes.push_back(node);
+        }
+
+        std::unordered_map<Agnode_t*, int> group_of;
+
+        for (size_t v = 0; v < n; v++)
+                if (nodes[v] and labels[v] >= 1 and group_of_label[labels[v]] >= 0)
+                        group_of[nodes[v]] = group_of_label[labels[v]];
+
+        // number of edges between each pair of groups
+        std::map<std::pair<int, int>, size_t> edges;
+        bool directed = agisdirected(g);
+
+        for (const auto& node : group_of)
+                for (Agedge_t* e = agfstout(g, node.first); e; e = agnxtout(g, e)) {
+                        auto head = group_of.find(aghead(e));
+
+                        if (head == group_of.end() or head->second == node.second)
+                                continue;
+
+                        if (directed)
+                                edges[{node.second, head->second}]++;
+                        else
+                                edges[std::minmax(node.second, head->second)]++;
+                }
+
+        for (const auto& edge : edges) {
+                Agedge_t* e = agedge(q, super_nodes[edge.first.first],
+                                super_nodes[edge.first.second], nullptr, 1);
+
+                set(e, weight_sym, std::to_string(edge.second));
+                set(e, penwidth_sym, std::to_string(1.0 + std::log2(edge.second)));
+        }
+
+        return overview;
+}
+
+gviz::cgraph gviz::induced_graph(gviz::cgraph& graph, const std::vector<Agnode_t*>& nodes,
+                const std::string& name)
+{
+        Agraph_t* g = graph.data();
+        cgraph detail(name, type_of(g, agisstrict(g)));
+        Agraph_t* d = detail.data();
+
+        // agcopyattr() needs the attributes declared in both graphs
+        for (int kind : {AGNODE, AGEDGE})
+                for (Agsym_t* sym = agnxtattr(g, kind, nullptr); sym; sym = agnxtattr(g, kind, sym))
+                        agattr(d, kind, sym->name, sym->defval);
+
+        std::vector<Agnode_t*> originals;
+        std::unordered_map<Agnode_t*, Agnode_t*> copies;
+
+        for (Agnode_t* node : nodes) {
+                if (!node or copies.count(node))
+                        continue;
+
+                Agnode_t* copy = agnode(d, agnameof(node), 1);
+                agcopyattr(node, copy);
+
+                originals.push_back(node);
+                copies[node] = copy;
+        }
+
+        for (Agnode_t* node : originals)
+                for (Agedge_t* e = agfstout(g, node); e; e = agnxtout(g, e)) {
+                        auto head = copies.find(aghead(e));
+
+                        if (head == copies.end())
+                                continue;
+
+                        Agedge_t* copy = agedge(d, copies[node], head->second, agnameof(e), 1);
+
+                        if (copy)
+                                agcopyattr(e, copy);
+                }
+
+        return detail;
+}
@@ -1,12 +1,93 @@
 /** @file */
 #include "grlib/utility.hpp"
 
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+std::atomic<unsigned> seed_generation(0);
+std::atomic<unsigned> seed_value(0);
+std::atomic<unsigned> threads_seeded(0);
+
+}
+
+void seed_randomize(unsigned seed)
+{
+        seed_value = seed;
+        threads_seeded = 0;
+        seed_generation++;
+}
+
 int randomize(int min,int max)
 {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        thread_local std::mt19937 gen(std::random_device{}());
+        thread_local unsigned generation = 0;
+
+        // seed_randomize() was called since the last use in this thread
+        if (generation != seed_generation) {
+                generation = seed_generation;
+                gen.seed(seed_value + 0x9E3779B9U * threads_seeded++);
+        }
+
         std::uniform_int_distribution<> dis(min,max);
 
         return dis(gen);
 }
 
+
+std::vector<std::string> generate_palette(size_t n, size_t offset)
+{
+        const double golden_ratio = 0.618033988749895;
+        // inverse powers of the plastic number, they spread (s, v) pairs like the golden
+        // ratio spreads hues, so saturation and value do not repeat in a few bands
+        const double plastic_ratio = 0.754877666246693;
+        const double plastic_ratio2 = 0.569840290998053;
+
+        // quantization to 8-bit RGB merges colors once most of the space is used
+        const size_t max_index = offset + 4 * n + 1024;
+
+        std::vector<std::string> palette;
+        std::unordered_set<std::string> seen;
+        palette.reserve(n);
+
+        for (size_t i = offset; palette.size() < n; i++) {
+                if (i == max_index)
+                        throw std::runtime_error("generate_palette(): not enough distinct colors");
+
+                double h = std::fmod(i * golden_ratio, 1.0) * 6.0;
+                double s = 0.40 + 0.55 * std::fmod(i * plastic_ratio, 1.0);
+                double v = 0.55 + 0.40 * std::fmod(i * plastic_ratio2, 1.0);
+
+                // HSV to RGB
+                int sector = static_cast<int>(h) % 6;
+                double f = h - std::floor(h);
+                double p = v * (1.0 - s);
+                double q = v * (1.0 - s * f);
+                double t = v * (1.0 - s * (1.0 - f));
+                double r, g, b;
+
+                switch (sector) {
+                case 0: r = v; g = t; b = p; break;
+                case 1: r = q; g = v; b = p; break;
+                case 2: r = p; g = v; b = t; break;
+                case 3: r = p; g = q; b = v; break;
+                case 4: r = t; g = p; b = v; break;
+                default: r = v; g = p; b = q; break;
+                }
+
+                char hex[8];
+                snprintf(hex, sizeof(hex), "#%02X%02X%02X",
+                        static_cast<int>(r * 255.0 + 0.5),
+                        static_cast<int>(g * 255.0 + 0.5),
+                        static_cast<int>(b * 255.0 + 0.5));
+
+                if (seen.insert(hex).second)
+                        palette.emplace_back(hex);
+        }
+
+        return palette;
+}
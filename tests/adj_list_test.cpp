@@ -15,6 +15,34 @@ int main()
                 }
 
         grlib::print_adj_list(graph);
+
+        // the same graph inserted at once
+        grlib::adj_list<grlib::Basic_edge> bulk((size_t)0);
+        std::vector<std::pair<grlib::vertex_id, grlib::Basic_edge>> arcs;
+
+        for (int i = 0; i < size; ++i)
+                for (int j = 0; j < size; ++j) {
+                        arcs.emplace_back(i, grlib::Basic_edge(j, -1));
+                        arcs.emplace_back(j, grlib::Basic_edge(i, -1));
+                }
+
+        // every edge is inserted twice, self-loops even four times
+        grlib::adj_list<grlib::Basic_edge> unique((size_t)0);
+        grlib::adj_list_options options;
+        options.dedupe = true;
+        options.drop_self_loops = true;
+        options.threads = 2;
+
+        unique.insert_edges(arcs, options);
+        unique.vmap = graph.vmap;
+
+        bulk.insert_edges(std::move(arcs), 2);
+        bulk.vmap = graph.vmap;
+
+        grlib::print_adj_list(bulk);
+        grlib::print_adj_list(unique);
+        std::cout << graph.edges_number() << " " << bulk.edges_number() << " "
+                << unique.edges_number() << "\n";
         return 0;
 }
 
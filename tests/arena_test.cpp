@@ -0,0 +1,77 @@
+/** @file */
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/arena.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/sccs.hpp"
+#include "graphviz/wrapper.hpp"
+
+/**
+ * Build adjacency list with random edges several times.
+ * @return milliseconds spent on building and destroying the lists
+ */
+template<typename Alloc>
+double measure(size_t vertices, size_t edges, int rounds, const Alloc& alloc)
+{
+        auto t0 = std::chrono::steady_clock::now();
+
+        for (int r = 0; r < rounds; r++) {
+                grlib::adj_list<grlib::Basic_edge, Alloc> alist(vertices, true, alloc);
+
+                for (size_t i = 0; i < edges; i++)
+                        alist.insert_edge(i % vertices, grlib::Basic_edge((i * 7919) % vertices, 0));
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        using arena_list = grlib::adj_list<grlib::Basic_edge, grlib::arena_allocator<grlib::Basic_edge>>;
+
+        auto resource = std::make_shared<grlib::arena>();
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        arena_list arena_alist(cgraph, grlib::arena_allocator<grlib::Basic_edge>(resource));
+
+        grlib::csr expected = grlib::make_csr(alist);
+        grlib::csr graph = grlib::make_csr(arena_alist);
+
+        if (expected.offsets != graph.offsets or expected.targets != graph.targets
+                        or expected.weights != graph.weights) {
+                std::cout << "arena adjacency list differs\n";
+                return 1;
+        }
+
+        std::cout << graph.edges_number() << " edges in " << resource->chunks_number()
+                << " chunks (" << resource->bytes_reserved() << " bytes)\n";
+
+        // algorithms written for adj_list work with any allocator
+        grlib::sccs_context<grlib::Basic_edge, grlib::arena_allocator<grlib::Basic_edge>> sccs_cxt(arena_alist);
+        grlib::sccs(sccs_cxt);
+        std::cout << sccs_cxt.components_number << " strongly connected components\n";
+
+        int rounds = argc > 2 ? std::stoi(argv[2]) : 5;
+
+        std::cout << "std::allocator: " << measure(100000, 1000000, rounds,
+                        std::allocator<grlib::Basic_edge>()) << " ms\n";
+        std::cout << "arena_allocator: " << measure(100000, 1000000, rounds,
+                        grlib::arena_allocator<grlib::Basic_edge>()) << " ms\n";
+
+        return 0;
+}
@@ -0,0 +1,38 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/betweenness.hpp"
+#include "grlib/csr.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::betweenness_context exact(graph);
+        grlib::betweenness(exact);
+
+        size_t samples = graph.vertices_number() / 2 + 1;
+        grlib::betweenness_context sampled(graph, samples, 42);
+        grlib::betweenness(sampled);
+
+        for (size_t i = 0; i < graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << exact.centrality[i]
+                        << " (sampled " << samples << ": " << sampled.centrality[i] << ")\n";
+
+        return 0;
+}
@@ -0,0 +1,51 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/biconnected.hpp"
+#include "grlib/csr.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::biconnected_context bc(graph);
+        grlib::biconnected_components(bc);
+
+        std::cout << "number of components: " << bc.components_number << "\n";
+
+        std::cout << "articulation points:";
+        for (size_t v = 0; v < graph.vertices_number(); v++)
+                if (bc.articulation[v])
+                        std::cout << " \"" << alist.vmap.names[v] << "\"";
+        std::cout << "\n";
+
+        std::cout << "bridges:";
+        for (const auto& bridge : bc.bridges)
+                std::cout << " \"" << alist.vmap.names[bridge.first] << "\" -- \""
+                        << alist.vmap.names[bridge.second] << "\"";
+        std::cout << "\n";
+
+        for (size_t x = 0; x < graph.vertices_number(); x++)
+                for (size_t i = bc.graph.offsets[x]; i < bc.graph.offsets[x + 1]; i++)
+                        if (static_cast<grlib::vertex_id>(x) < bc.graph.targets[i])
+                                std::cout << "\"" << alist.vmap.names[x] << "\" -- \""
+                                        << alist.vmap.names[bc.graph.targets[i]] << "\": "
+                                        << bc.component[i] << "\n";
+
+        return 0;
+}
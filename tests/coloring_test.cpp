@@ -0,0 +1,44 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/coloring.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/utility.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::coloring_context cc(graph);
+        grlib::coloring(cc);
+
+        std::vector<std::string> palette = generate_palette(cc.colors_number);
+        size_t conflicts = 0;
+
+        for (size_t x = 0; x < graph.vertices_number(); x++)
+                for (grlib::vertex_id y : cc.graph.neighbors(x))
+                        conflicts += cc.color[x] == cc.color[y];
+
+        std::cout << "number of colors: " << cc.colors_number << ", conflicts: " << conflicts << "\n";
+
+        for (size_t i = 0; i < graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << cc.color[i]
+                        << " " << palette[cc.color[i]] << "\n";
+
+        return 0;
+}
@@ -0,0 +1,36 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/communities.hpp"
+#include "grlib/csr.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::communities_context cc(graph);
+        grlib::label_propagation(cc);
+
+        std::cout << "number of communities: " << cc.communities_number
+                << ", iterations: " << cc.iterations << "\n";
+
+        for (size_t i = 0; i < graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << cc.community[i] << "\n";
+
+        return 0;
+}
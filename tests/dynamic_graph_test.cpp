@@ -0,0 +1,70 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/bfs.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/dynamic_graph.hpp"
+#include "graphviz/wrapper.hpp"
+
+template<typename Edge>
+void print_dynamic_graph(const grlib::dynamic_graph<Edge>& graph)
+{
+        std::cout << "vertices: " << graph.alive_number() << " (tombstones: " << graph.dead_number()
+                << "), edges: " << graph.edges_number() << "\n";
+
+        for (size_t v = 0; v < graph.vertices_number(); v++) {
+                if (!graph.alive(v))
+                        continue;
+
+                std::cout << "\"" << graph.vmap.names[v] << "\": ";
+
+                for (grlib::vertex_id y : graph.neighbors(v))
+                        std::cout << "\"" << graph.vmap.names[y] << "\" -> ";
+
+                std::cout << "$\n";
+        }
+}
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::dynamic_graph<grlib::Basic_edge> graph(cgraph);
+        print_dynamic_graph(graph);
+
+        if (graph.vertices_number() == 0)
+                return 0;
+
+        // drop first edge of the last vertex, then the first vertex entirely
+        grlib::vertex_id last = graph.vertices_number() - 1;
+        if (!graph.edges[last].empty())
+                graph.remove_edge(last, graph.edges[last].front().y);
+
+        graph.remove_vertex(0);
+        grlib::vertex_id added = graph.add_vertex("added");
+        graph.insert_edge(added, grlib::Basic_edge(last, 1));
+        print_dynamic_graph(graph);
+
+        graph.compact();
+        print_dynamic_graph(graph);
+
+        grlib::csr snapshot = graph.to_csr();
+        grlib::bfs_workspace ws(graph.vertices_number());
+        grlib::bfs_levels(graph, 0, ws);
+
+        std::cout << "snapshot: " << snapshot.vertices_number() << " vertices, "
+                << snapshot.edges_number() << " edges, reachable from \""
+                << graph.vmap.names[0] << "\": " << ws.queue.size() << "\n";
+
+        return 0;
+}
@@ -1,9 +1,22 @@
 /** @file */
 #include <gtest/gtest.h>
 
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <set>
 #include <string>
 #include "graphviz/wrapper.hpp"
+#include "grlib/adj_list.hpp"
+#include "grlib/dynamic_graph.hpp"
+#include "grlib/pagerank.hpp"
+#include "grlib/reorder.hpp"
+#include "grlib/shortest_path.hpp"
+#include "grlib/utility.hpp"
 
 using std::tuple;
 using std::make_tuple;
@@ -224,6 +237,410 @@ INSTANTIATE_TEST_CASE_P(
                 make_tuple("style", "filed")
         ));
 
+// Tests rendering into memory buffer
+TEST(GraphvizWrapperTest, RenderToMemory)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        gviz::graphviz_context context(cgraph, "dot");
+
+        std::vector<char> plain = gviz::render_to_memory(context, cgraph, "plain");
+        ASSERT_GT(plain.size(), 5UL);
+        EXPECT_EQ(std::string(plain.begin(), plain.begin() + 5), "graph");
+
+        // buffer is reused by the next frame
+        std::vector<char> buffer;
+        size_t size = gviz::render_to_memory(context, cgraph, "png", buffer);
+        ASSERT_GT(size, 8UL);
+        EXPECT_EQ(size, buffer.size());
+        EXPECT_EQ(std::string(buffer.begin() + 1, buffer.begin() + 4), "PNG");
+
+        const char* data = buffer.data();
+        EXPECT_EQ(gviz::render_to_memory(context, cgraph, "png", buffer), size);
+        EXPECT_EQ(buffer.data(), data);
+
+        EXPECT_THROW(gviz::render_to_memory(context, cgraph, "no_such_format", buffer),
+                        std::runtime_error);
+}
+
+// Tests decoding of gd images and writing of animated gif.
+TEST(GraphvizWrapperTest, GifAnimation)
+{
+        // 2x1 truecolor gd image: red and half transparent black pixel
+        std::vector<char> gd = {'\xFF', '\xFE', 0, 2, 0, 1, 1, '\xFF', '\xFF', '\xFF', '\xFF',
+                0, '\xFF', 0, 0, 64, 0, 0, 0};
+
+        gviz::rgb_image image;
+        gviz::decode_gd(gd, image);
+        ASSERT_EQ(image.width, 2UL);
+        ASSERT_EQ(image.height, 1UL);
+        EXPECT_EQ(image.pixels[0], 0xFF0000U);
+        EXPECT_EQ(image.pixels[1], 0x808080U);
+
+        gd.pop_back();
+        EXPECT_THROW(gviz::decode_gd(gd, image), std::runtime_error);
+
+        const char* file_name = "gtest_animation.gif";
+
+        {
+                gviz::gif_animation animation(file_name, 20);
+                animation.add_frame(image);
+                animation.add_frame(image);
+                image.pixels[1] = 0x00FF00;
+                animation.add_frame(image);
+                EXPECT_EQ(animation.frames_number(), 3UL);
+
+                image.width = 1;
+                EXPECT_THROW(animation.add_frame(image), std::runtime_error);
+        }
+
+        std::ifstream file(file_name, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::remove(file_name);
+
+        ASSERT_GT(content.size(), 6UL);
+        EXPECT_EQ(content.substr(0, 6), "GIF89a");
+        EXPECT_EQ(content.back(), '\x3B');
+
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        gviz::graphviz_context context(cgraph, "dot");
+        gviz::gif_animation animation(file_name);
+        gviz::render(context, cgraph, animation);
+        animation.close();
+        std::remove(file_name);
+
+        EXPECT_EQ(animation.frames_number(), 1UL);
+        EXPECT_THROW(gviz::render(context, cgraph, animation), std::runtime_error);
+}
+
+// Tests recording attribute changes and rendering frames in worker processes.
+TEST(GraphvizWrapperTest, FrameRecorder)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        gviz::graphviz_context context(cgraph, "dot");
+        gviz::frame_recorder recorder;
+
+        gviz::Node a = cgraph.find_node("A");
+        gviz::Node b = cgraph.find_node("B");
+        gviz::Edge edge = cgraph.find_edge(a, b);
+
+        recorder.frame();
+        EXPECT_TRUE(recorder.set_attr(a, "fillcolor", "#ff4000"));
+        recorder.frame();
+        EXPECT_TRUE(recorder.set_attr(edge, "color", "red"));
+        EXPECT_TRUE(recorder.set_attr_safe(b, "penwidth", "3", "1"));
+        recorder.frame();
+        EXPECT_FALSE(recorder.set_attr(b, "no_such_attribute", "1"));
+        ASSERT_EQ(recorder.frames_number(), 3UL);
+
+        recorder.seek(0);
+        EXPECT_EQ(a.get_attr("fillcolor"), "#4dd2ff");
+        EXPECT_EQ(edge.get_attr("color"), "#708090");
+        EXPECT_EQ(b.get_attr("penwidth"), "1");
+
+        recorder.seek(1);
+        EXPECT_EQ(a.get_attr("fillcolor"), "#ff4000");
+        EXPECT_EQ(edge.get_attr("color"), "#708090");
+
+        recorder.seek_end();
+        EXPECT_EQ(edge.get_attr("color"), "red");
+        EXPECT_EQ(b.get_attr("penwidth"), "3");
+
+        EXPECT_THROW(recorder.seek(3), std::runtime_error);
+
+        // rendering does not depend on the frame shown before
+        recorder.seek(0);
+        gviz::render_frames(context, cgraph, recorder, "plain", 2);
+
+        std::vector<std::string> frames;
+        for (int i = 0; i < 3; i++) {
+                std::string file_name = std::to_string(i) + ".plain";
+                std::ifstream file(file_name);
+                frames.emplace_back((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                std::remove(file_name.c_str());
+        }
+
+        EXPECT_EQ(frames[0].find("#ff4000"), std::string::npos);
+        EXPECT_NE(frames[1].find("#ff4000"), std::string::npos);
+        EXPECT_NE(frames[2].find("red"), std::string::npos);
+
+        // graph is left in the final state
+        EXPECT_EQ(edge.get_attr("color"), "red");
+}
+
+// Tests whether layout is computed once and restored from the cache later.
+TEST(GraphvizWrapperTest, LayoutCache)
+{
+        std::string position;
+        std::uint64_t hash;
+
+        {
+                gviz::cgraph cgraph("graphs/complex_graph.dot");
+                ASSERT_TRUE(cgraph);
+
+                hash = gviz::layout_hash(cgraph, "neato");
+                EXPECT_NE(hash, gviz::layout_hash(cgraph, "sfdp"));
+
+                gviz::graphviz_context context;
+                EXPECT_FALSE(gviz::set_cached_layout(context, cgraph, "neato", "."));
+                position = cgraph.find_node("A").get_attr("pos");
+        }
+
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+        EXPECT_EQ(gviz::layout_hash(cgraph, "neato"), hash);
+
+        gviz::graphviz_context context;
+        EXPECT_TRUE(gviz::set_cached_layout(context, cgraph, "neato", "."));
+        EXPECT_EQ(cgraph.find_node("A").get_attr("pos"), position);
+        EXPECT_GT(gviz::render_to_memory(context, cgraph, "png").size(), 0UL);
+
+        char file_name[32];
+        snprintf(file_name, sizeof(file_name), "%016" PRIx64 ".layout", hash);
+        EXPECT_EQ(std::remove(file_name), 0);
+}
+
+// Tests skipping frames equal to the previous one and sampling of long animations.
+TEST(GraphvizWrapperTest, FrameSampling)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        gviz::frame_recorder recorder;
+        gviz::Node a = cgraph.find_node("A");
+        gviz::Node b = cgraph.find_node("B");
+
+        EXPECT_TRUE(recorder.frame());
+        EXPECT_FALSE(recorder.frame());
+
+        // the same value again, then a change reverted within the step
+        std::uint64_t hash = recorder.state_hash();
+        EXPECT_TRUE(recorder.set_attr(a, "fillcolor", "#4dd2ff"));
+        EXPECT_TRUE(recorder.set_attr(b, "fillcolor", "#ff4000"));
+        EXPECT_TRUE(recorder.set_attr(b, "fillcolor", "#4dd2ff"));
+        EXPECT_EQ(recorder.state_hash(), hash);
+        EXPECT_FALSE(recorder.frame());
+
+        for (int i = 0; i < 10; i++) {
+                recorder.set_attr(a, "fillcolor", i % 2 ? "#ff4000" : "#0080ff");
+                EXPECT_TRUE(recorder.frame());
+        }
+
+        ASSERT_EQ(recorder.frames_number(), 11UL);
+
+        // frames 0, 4, 8 and the last one
+        recorder.sample(4);
+        ASSERT_EQ(recorder.frames_number(), 4UL);
+        recorder.seek(3);
+        EXPECT_EQ(a.get_attr("fillcolor"), "#ff4000");
+
+        recorder.limit(2);
+        ASSERT_EQ(recorder.frames_number(), 2UL);
+        recorder.seek(0);
+        EXPECT_EQ(a.get_attr("fillcolor"), "#4dd2ff");
+        recorder.seek(1);
+        EXPECT_EQ(a.get_attr("fillcolor"), "#ff4000");
+}
+
+// Tests attribute handles and nodes of vertices kept by adjacency list.
+TEST(GraphvizWrapperTest, AttributeHandle)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        gviz::Attribute invalid;
+        EXPECT_FALSE(invalid);
+        EXPECT_FALSE(gviz::Attribute(cgraph, AGNODE, "no_such_attribute"));
+
+        gviz::Attribute fillcolor(cgraph, AGNODE, "fillcolor");
+        ASSERT_TRUE(fillcolor);
+        EXPECT_EQ(fillcolor.name(), "fillcolor");
+
+        gviz::Attribute penwidth(cgraph, AGNODE, "penwidth", "2");
+        ASSERT_TRUE(penwidth);
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::vertex_id a = alist.vmap.index("A");
+        gviz::Node node(alist.vmap.node(a));
+
+        ASSERT_TRUE(node);
+        EXPECT_EQ(node.name(), "A");
+        EXPECT_EQ(fillcolor.get(node), "#4dd2ff");
+        EXPECT_EQ(penwidth.get(node), "2");
+
+        EXPECT_TRUE(fillcolor.set(node, "#ff4000"));
+        EXPECT_EQ(node.get_attr("fillcolor"), "#ff4000");
+        EXPECT_FALSE(invalid.set(node, "1"));
+        EXPECT_THROW(invalid.get(node), std::runtime_error);
+
+        // vertex without a Graphviz node
+        EXPECT_EQ(alist.vmap.node(cgraph.nodes_number()), nullptr);
+}
+
+// Tests overview of groups of nodes and copying nodes to a detail graph.
+TEST(GraphvizWrapperTest, LargeGraphOverview)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        // subtrees of B and F, the rest of the graph
+        std::map<std::string, int> groups = {{"B", 1}, {"I", 1}, {"J", 1}, {"K", 1}, {"L", 1},
+                {"M", 1}, {"F", 2}, {"U", 2}, {"W", 2}, {"X", 2}, {"Y", 2}, {"Z", 2}};
+        std::vector<Agnode_t*> nodes;
+        std::vector<int> labels;
+
+        for (gviz::Node node : cgraph) {
+                nodes.push_back(node.data());
+                labels.push_back(groups.count(node.name()) ? groups[node.name()] : 3);
+        }
+
+        gviz::cgraph overview = gviz::quotient_graph(cgraph, nodes, labels, 0);
+        ASSERT_TRUE(overview);
+        EXPECT_EQ(overview.nodes_number(), 3);
+        EXPECT_EQ(agnedges(overview.data()), 2);
+        EXPECT_EQ(overview.find_node("1").get_attr("members"), "6");
+        EXPECT_EQ(overview.find_node("3").get_attr("members"), "11");
+        EXPECT_TRUE(gviz::set_large_graph_attrs(overview));
+
+        // groups 1 and 2 merged, their edges to group 3 too
+        gviz::cgraph merged = gviz::quotient_graph(cgraph, nodes, labels, 2);
+        ASSERT_EQ(merged.nodes_number(), 2);
+        ASSERT_EQ(agnedges(merged.data()), 1);
+
+        gviz::Node other = merged.find_node("other");
+        gviz::Node largest = merged.find_node("3");
+        ASSERT_TRUE(other);
+        EXPECT_EQ(other.get_attr("members"), "12");
+        EXPECT_EQ(merged.find_edge(largest, other).get_attr("weight"), "2");
+
+        std::vector<Agnode_t*> detail_nodes;
+        for (size_t i = 0; i < nodes.size(); i++)
+                if (labels[i] == 1)
+                        detail_nodes.push_back(nodes[i]);
+
+        gviz::cgraph detail = gviz::induced_graph(cgraph, detail_nodes, "component_1");
+        ASSERT_TRUE(detail);
+        EXPECT_EQ(detail.nodes_number(), 6);
+        EXPECT_EQ(agnedges(detail.data()), 5);
+        EXPECT_FALSE(detail.is_directed());
+        EXPECT_EQ(detail.find_node("B").get_attr("shape"), "doublecircle");
+        EXPECT_FALSE(detail.find_node("A"));
+}
+
+// Tests that Graphviz nodes of vertices follow them when vertices are renumbered.
+TEST(GraphvizWrapperTest, VertexNodesRenumbered)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        size_t n = alist.vertices_capacity();
+        std::vector<grlib::vertex_id> perm(n);
+
+        for (size_t v = 0; v < n; v++)
+                perm[v] = n - 1 - v;
+
+        grlib::permute(alist, perm);
+
+        for (size_t v = 0; v < n; v++)
+                if (!alist.vmap.names[v].empty()) {
+                        ASSERT_NE(alist.vmap.node(v), nullptr);
+                        EXPECT_EQ(agnameof(alist.vmap.node(v)), alist.vmap.names[v]);
+                }
+
+        grlib::dynamic_graph<grlib::Basic_edge> graph(cgraph);
+        grlib::vertex_id a = graph.vmap.index("A");
+
+        graph.remove_vertex(a);
+        EXPECT_EQ(graph.vmap.node(a), nullptr);
+
+        graph.compact();
+        for (size_t v = 0; v < graph.vmap.max_index; v++)
+                EXPECT_EQ(agnameof(graph.vmap.node(v)), graph.vmap.names[v]);
+
+        grlib::vertex_id added = graph.add_vertex("new");
+        EXPECT_EQ(graph.vmap.node(added), nullptr);
+}
+
+// Tests that preallocated, unused slots of adjacency list take no part of PageRank.
+TEST(GrlibPagerankTest, PreallocatedSlots)
+{
+        grlib::adj_list<grlib::Basic_edge> alist;
+        ASSERT_GT(alist.vertices_capacity(), 4UL);
+
+        alist.insert_edge(0, grlib::Basic_edge(1, 1));
+        alist.insert_edge(1, grlib::Basic_edge(2, 1));
+        alist.insert_edge(2, grlib::Basic_edge(0, 1));
+        alist.insert_edge(2, grlib::Basic_edge(3, 1));
+
+        EXPECT_EQ(alist.vertices_number(), 4UL);
+        EXPECT_EQ(grlib::make_csr(alist).vertices_number(), 4UL);
+
+        std::vector<double> rank = grlib::pagerank(alist);
+        ASSERT_EQ(rank.size(), 4UL);
+        EXPECT_NEAR(std::accumulate(rank.begin(), rank.end(), 0.0), 1.0, 1e-6);
+
+        // the same graph without spare slots
+        grlib::adj_list<grlib::Basic_edge> exact(4);
+        exact.insert_edge(0, grlib::Basic_edge(1, 1));
+        exact.insert_edge(1, grlib::Basic_edge(2, 1));
+        exact.insert_edge(2, grlib::Basic_edge(0, 1));
+        exact.insert_edge(2, grlib::Basic_edge(3, 1));
+
+        std::vector<double> expected = grlib::pagerank(exact);
+        for (size_t v = 0; v < rank.size(); v++)
+                EXPECT_NEAR(rank[v], expected[v], 1e-9);
+}
+
+// Tests that positions of nodes computed by layout are read.
+TEST(GraphvizWrapperTest, NodePositions)
+{
+        gviz::cgraph cgraph("graphs/complex_graph.dot");
+        ASSERT_TRUE(cgraph);
+
+        gviz::graphviz_context context(cgraph, "neato");
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+        auto pos = grlib::node_positions(cgraph, alist.vmap);
+
+        ASSERT_EQ(pos.size(), alist.vmap.names.size());
+
+        // nodes do not overlap, so at most one of them is at the origin
+        size_t at_origin = 0;
+        for (size_t v = 0; v < alist.vmap.max_index; v++)
+                at_origin += pos[v].first == 0.0 and pos[v].second == 0.0;
+        EXPECT_LE(at_origin, 1UL);
+
+        // the file has no weights, unit ones make edge lengths matter
+        graph.weights.assign(graph.weights.size(), 1);
+        EXPECT_GT(grlib::consistent_scale(graph, pos), 0.0);
+
+        context.free_layout(cgraph);
+}
+
+// Tests that palettes larger than a few bands of saturation and value stay distinct.
+TEST(GrlibUtilityTest, LargePalette)
+{
+        std::vector<std::string> palette = generate_palette(20000);
+        ASSERT_EQ(palette.size(), 20000UL);
+
+        std::set<std::string> unique(palette.begin(), palette.end());
+        EXPECT_EQ(unique.size(), palette.size());
+
+        Color_pool pool(20000);
+        std::set<std::string> pool_colors;
+        for (size_t i = 0; i < 20000; i++)
+                pool_colors.insert(pool.next_color());
+        EXPECT_EQ(pool_colors.size(), 20000UL);
+        EXPECT_THROW(pool.next_color(), std::runtime_error);
+}
+
 int main(int argc, char *argv[])
 {
         ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,39 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/kcore.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::kcore_context kc(graph);
+        grlib::kcore(kc);
+
+        grlib::kcore_context parallel(graph);
+        grlib::kcore_parallel(parallel);
+
+        std::cout << "max core: " << kc.max_core << ", parallel: " << parallel.max_core << "\n";
+
+        for (size_t i = 0; i < graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << kc.core[i]
+                        << " (parallel: " << parallel.core[i] << ")\n";
+
+        return 0;
+}
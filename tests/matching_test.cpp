@@ -0,0 +1,40 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/matching.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+
+        try {
+                grlib::matching_context mc(grlib::make_csr(alist));
+                grlib::hopcroft_karp(mc);
+
+                std::cout << "matching size: " << mc.size << "\n";
+
+                for (size_t i = 0; i < mc.mate.size(); i++)
+                        if (mc.side[i] == 0 and mc.mate[i] >= 0)
+                                std::cout << "\"" << alist.vmap.names[i] << "\" -- \""
+                                        << alist.vmap.names[mc.mate[i]] << "\"\n";
+        } catch (std::exception& e) {
+                std::cout << e.what() << "\n";
+        }
+
+        return 0;
+}
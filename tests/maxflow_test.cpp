@@ -0,0 +1,37 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/maxflow.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 4) {
+                std::cout << "Usage: maxflow_test [FILE] [SOURCE] [SINK]\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::maxflow_context mf(graph, alist.vmap.index(argv[2]), alist.vmap.index(argv[3]));
+        grlib::max_flow(mf);
+
+        std::cout << "max flow: " << mf.flow << "\n";
+        std::cout << "min cut:\n";
+
+        for (const auto& edge : mf.cut_edges)
+                std::cout << "\"" << alist.vmap.names[edge.first] << "\" -> \""
+                        << alist.vmap.names[edge.second] << "\"\n";
+
+        return 0;
+}
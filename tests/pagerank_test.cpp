@@ -0,0 +1,40 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/pagerank.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::pagerank_context pr(graph);
+        grlib::pagerank(pr);
+
+        grlib::pagerank_context delta(graph);
+        grlib::pagerank_delta(delta);
+
+        std::cout << "iterations: " << pr.iterations << ", delta iterations: "
+                << delta.iterations << "\n";
+
+        for (size_t i = 0; i < graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << pr.rank[i]
+                        << " (delta: " << delta.rank[i] << ")\n";
+
+        return 0;
+}
@@ -0,0 +1,42 @@
+/** @file */
+#include <iostream>
+#include <string>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/partition.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        int parts = argc > 2 ? std::stoi(argv[2]) : 2;
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::partition_context pc(graph, parts);
+        grlib::partition(pc);
+
+        std::cout << "edge cut: " << pc.edge_cut << "\n";
+
+        for (int p = 0; p < pc.parts; p++)
+                std::cout << "part " << p << ": " << pc.part_size[p] << " vertices, "
+                        << pc.cut_edges[p] << " cut edges\n";
+
+        for (size_t i = 0; i < graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << pc.part[i] << "\n";
+
+        return 0;
+}
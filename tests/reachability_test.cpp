@@ -0,0 +1,51 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/reachability.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        grlib::reachability_context closure(graph);
+        grlib::transitive_closure(closure);
+
+        grlib::reachability_context index(graph);
+        grlib::interval_labeling(index);
+
+        std::cout << "components: " << closure.cond.components_number
+                << ", intervals: " << index.intervals.size() << "\n";
+
+        for (size_t u = 0; u < graph.vertices_number(); u++) {
+                std::cout << "\"" << alist.vmap.names[u] << "\":";
+
+                for (size_t v = 0; v < graph.vertices_number(); v++) {
+                        bool r = grlib::reachable(closure, u, v);
+
+                        if (r)
+                                std::cout << " \"" << alist.vmap.names[v] << "\"";
+                        if (r != grlib::reachable(index, u, v))
+                                std::cout << " (index mismatch)";
+                }
+
+                std::cout << "\n";
+        }
+
+        return 0;
+}
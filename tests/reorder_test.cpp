@@ -0,0 +1,85 @@
+/** @file */
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/bfs.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/pagerank.hpp"
+#include "grlib/reorder.hpp"
+#include "graphviz/wrapper.hpp"
+
+/**
+ * Time full BFS sweeps and single-threaded PageRank on the graph.
+ * @return milliseconds of BFS and PageRank
+ */
+std::pair<double, double> measure(const grlib::csr& graph, int rounds)
+{
+        using clock = std::chrono::steady_clock;
+        grlib::bfs_workspace ws(graph.vertices_number());
+        size_t n = graph.vertices_number();
+
+        auto t0 = clock::now();
+
+        for (int r = 0; r < rounds; r++)
+                for (size_t s = 0; s < n; s += std::max<size_t>(1, n / 16))
+                        grlib::bfs_levels(graph, s, ws);
+
+        auto t1 = clock::now();
+
+        for (int r = 0; r < rounds; r++) {
+                grlib::pagerank_context pr(graph, 0.85, 1e-9, 20, 1);
+                grlib::pagerank(pr);
+        }
+
+        auto t2 = clock::now();
+
+        return {std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t2 - t1).count()};
+}
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        int rounds = argc > 2 ? std::stoi(argv[2]) : 10;
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        auto base = measure(graph, rounds);
+        std::cout << "original: bfs " << base.first << " ms, pagerank " << base.second << " ms\n";
+
+        std::pair<std::string, std::vector<grlib::vertex_id>> orders[] = {
+                {"degree", grlib::degree_order(graph)},
+                {"rcm", grlib::rcm_order(graph)},
+                {"gorder", grlib::gorder_order(graph)},
+        };
+
+        for (const auto& order : orders) {
+                auto t = measure(grlib::permute(graph, order.second), rounds);
+
+                std::cout << order.first << ": bfs " << t.first << " ms (x" << base.first / t.first
+                        << "), pagerank " << t.second << " ms (x" << base.second / t.second << ")\n";
+        }
+
+        // names follow their vertices
+        grlib::permute(alist, orders[1].second);
+
+        for (size_t i = 0; i < alist.vertices_capacity(); i++)
+                std::cout << i << ": \"" << alist.vmap.names[i] << "\" (index "
+                        << alist.vmap.index(alist.vmap.names[i]) << ")\n";
+
+        return 0;
+}
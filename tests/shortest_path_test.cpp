@@ -0,0 +1,45 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/shortest_path.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 4) {
+                std::cout << "Usage: shortest_path_test [FILE] [SOURCE] [TARGET]\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        // layout computes coordinates of nodes, see node_positions()
+        gviz::graphviz_context context(cgraph, "neato");
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::csr graph = grlib::make_csr(alist);
+
+        auto pos = grlib::node_positions(cgraph, alist.vmap);
+        grlib::vertex_id s = alist.vmap.index(argv[2]);
+        grlib::vertex_id t = alist.vmap.index(argv[3]);
+
+        grlib::shortest_path_context sp(graph);
+
+        std::cout << "dijkstra: " << grlib::astar(sp, s, t) << "\n";
+        std::cout << "A* (euclidean): " << grlib::astar(sp, s, t,
+                grlib::euclidean_heuristic(pos, grlib::consistent_scale(graph, pos))) << "\n";
+        std::cout << "bidirectional dijkstra: " << grlib::bidirectional_dijkstra(sp, s, t) << "\n";
+
+        for (grlib::vertex_id v : grlib::shortest_path(sp))
+                std::cout << "\"" << alist.vmap.names[v] << "\" ";
+
+        std::cout << "\n";
+        return 0;
+}
@@ -0,0 +1,37 @@
+/** @file */
+#include <iostream>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/csr.hpp"
+#include "grlib/triangles.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+
+        grlib::triangles_context tc(grlib::make_csr(alist));
+        grlib::triangles(tc);
+
+        std::cout << "number of triangles: " << tc.triangles_number << "\n";
+        std::cout << "average clustering: " << tc.average_clustering << "\n";
+        std::cout << "transitivity: " << tc.transitivity << "\n";
+
+        for (size_t i = 0; i < tc.graph.vertices_number(); i++)
+                std::cout << "\"" << alist.vmap.names[i] << "\": " << tc.triangles[i]
+                        << " (clustering: " << tc.clustering[i] << ")\n";
+
+        return 0;
+}
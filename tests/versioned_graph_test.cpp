@@ -0,0 +1,72 @@
+/** @file */
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "grlib/adj_list.hpp"
+#include "grlib/bfs.hpp"
+#include "grlib/versioned_graph.hpp"
+#include "graphviz/wrapper.hpp"
+
+int main(int argc, char** argv)
+{
+        if (argc < 2) {
+                std::cout << "No file provided\n";
+                return 0;
+        }
+
+        gviz::cgraph cgraph{argv[1]};
+
+        if (!cgraph) {
+                std::cout << "Reading file:" << argv[1] << " failed.\n";
+                return 0;
+        }
+
+        grlib::adj_list<grlib::Basic_edge> alist(cgraph);
+        grlib::versioned_graph<grlib::Basic_edge> graph(alist);
+
+        auto first = graph.snapshot();
+        size_t n = first->vertices_number();
+
+        if (n == 0)
+                return 0;
+
+        // readers traverse snapshots while the writer links vertices into a chain
+        std::atomic<bool> done(false);
+        std::atomic<size_t> traversals(0);
+        std::vector<std::thread> readers;
+
+        for (int i = 0; i < 4; i++)
+                readers.emplace_back([&] {
+                        grlib::bfs_workspace ws(n);
+
+                        while (!done) {
+                                auto snapshot = graph.snapshot();
+                                grlib::bfs_levels(*snapshot, 0, ws);
+                                traversals++;
+                        }
+                });
+
+        for (size_t v = 0; v + 1 < n; v++)
+                graph.insert_edge(v, grlib::Basic_edge(v + 1, 1));
+
+        done = true;
+        for (auto& reader : readers)
+                reader.join();
+
+        auto last = graph.snapshot();
+        grlib::bfs_workspace ws(n);
+
+        grlib::bfs_levels(*first, 0, ws);
+        std::cout << "version " << first->number << ": " << first->edges_number()
+                << " arcs, reachable from \"" << alist.vmap.names[0] << "\": " << ws.queue.size() << "\n";
+
+        grlib::bfs_levels(*last, 0, ws);
+        std::cout << "version " << last->number << ": " << last->edges_number()
+                << " arcs, reachable from \"" << alist.vmap.names[0] << "\": " << ws.queue.size() << "\n";
+
+        std::cout << "traversals during updates: " << (traversals > 0 ? "yes" : "no") << "\n";
+
+        return 0;
+}